@@ -0,0 +1,52 @@
+#include "Bench.h"
+#include "Game/include/AABBKernel.h"
+#include <random>
+
+namespace
+{
+AABBBatch MakeBoxes(std::size_t count, unsigned seed)
+{
+	std::default_random_engine random(seed);
+	std::uniform_real_distribution<float> position(0.f, 1000.f);
+	std::uniform_real_distribution<float> size(8.f, 64.f);
+
+	AABBBatch batch;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const float x(position(random));
+		const float y(position(random));
+		batch.Add(AABB { x, y, x + size(random), y + size(random) });
+	}
+	return batch;
+}
+}
+
+void RunAABBKernelBenchmarks(BenchRunner& runner, std::size_t candidateCount)
+{
+	//Enough tests per run that the timer sees them.
+	const std::size_t queryCount(candidateCount < 1000000 ? 1000000 / candidateCount : 1);
+
+	for (auto type : { AABBKernelType::Scalar, AABBKernelType::SSE, AABBKernelType::AVX2 })
+	{
+		const AABBKernel kernel(GetAABBKernel(type));
+		if (kernel == nullptr)
+			continue;
+
+		runner.Run(std::string("AABBKernel/") + GetAABBKernelName(type), candidateCount, [kernel, candidateCount, queryCount]() -> BenchRunner::Work {
+			auto candidates(std::make_shared<AABBBatch>(MakeBoxes(candidateCount, 1)));
+			auto queries(std::make_shared<AABBBatch>(MakeBoxes(queryCount, 2)));
+			return [kernel, candidates, queries]() {
+				std::vector<std::uint64_t> hits(util::GetHitWords(candidates->Size()));
+				float found { 0.f };
+				for (std::size_t q = 0; q < queries->Size(); ++q)
+				{
+					const AABB box { queries->Left[q], queries->Top[q], queries->Right[q], queries->Bottom[q] };
+					kernel(box, *candidates, hits.data());
+					found += static_cast<float>(hits[0] & 1u);
+				}
+				DoNotOptimize(found);
+				return queries->Size() * candidates->Size();
+			};
+		});
+	}
+}
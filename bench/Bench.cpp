@@ -0,0 +1,70 @@
+#include "Bench.h"
+#include <iomanip>
+#include <iostream>
+
+static volatile float sink { 0.f };
+
+void DoNotOptimize(float value)
+{
+	sink = value;
+}
+
+void BenchRunner::Run(const std::string& name, std::size_t entities, const Setup& setup)
+{
+	BenchResult result { name, entities, 0, 0, 0.0 };
+	for (std::size_t i = 0; i < repeats; ++i)
+	{
+		//A fresh world for every run, destroyed before the next.
+		Work work(setup());
+
+		const auto start(std::chrono::steady_clock::now());
+		const BenchCount count(work());
+		const std::chrono::duration<double, std::milli> elapsed(std::chrono::steady_clock::now() - start);
+		const double ms(count.TimedMs >= 0.0 ? count.TimedMs : elapsed.count());
+
+		if (i > 0 && (count.Operations != result.Operations || count.Hits != result.Hits))
+			std::cerr << "Warning! " << name << " does not count the same every run." << std::endl;
+		if (i == 0 || ms < result.BestMs)
+			result.BestMs = ms;
+		result.Operations = count.Operations;
+		result.Hits = count.Hits;
+	}
+
+	std::cerr << std::left << std::setw(36) << name << std::right << std::setw(9) << entities
+			  << std::setw(12) << std::fixed << std::setprecision(3) << result.BestMs << " ms"
+			  << std::setw(10) << std::setprecision(1) << result.NsPerOperation() << " ns/op" << std::endl;
+	results.emplace_back(result);
+}
+
+void BenchRunner::WriteJson(std::ostream& out) const
+{
+	out << "{\n\t\"repeats\": " << repeats << ",\n\t\"results\": [";
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		const BenchResult& r(results[i]);
+		out << (i == 0 ? "\n" : ",\n")
+			<< "\t\t{ \"name\": \"" << r.Name << "\""
+			<< ", \"entities\": " << r.Entities
+			<< ", \"operations\": " << r.Operations
+			<< ", \"hits\": " << r.Hits
+			<< std::fixed << std::setprecision(6)
+			<< ", \"best_ms\": " << r.BestMs
+			<< std::setprecision(3)
+			<< ", \"ns_per_op\": " << r.NsPerOperation()
+			<< std::setprecision(0)
+			<< ", \"ops_per_sec\": " << r.OperationsPerSecond() << " }";
+	}
+	out << "\n\t]\n}\n";
+}
+
+void BenchRunner::WriteCsv(std::ostream& out) const
+{
+	out << "name,entities,operations,hits,best_ms,ns_per_op,ops_per_sec\n";
+	for (auto& r : results)
+	{
+		out << r.Name << ',' << r.Entities << ',' << r.Operations << ',' << r.Hits << ','
+			<< std::fixed << std::setprecision(6) << r.BestMs << ','
+			<< std::setprecision(3) << r.NsPerOperation() << ','
+			<< std::setprecision(0) << r.OperationsPerSecond() << '\n';
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/////////////////////////////////////////////////
+///This file defines a tiny benchmark harness.
+///
+///Every case builds its own world, times one piece
+///of work a few times and keeps the best run, so
+///a result is the cost of the work alone and not of
+///the setup or of a noisy neighbour.
+///
+///Results are written as JSON or CSV so runs before
+///and after a change can be compared by a script.
+/////////////////////////////////////////////////
+//What one run of the work did.
+struct BenchCount
+{
+	std::size_t Operations;
+	std::size_t Hits { 0 };  //What the work found, e.g. contacts.
+	double TimedMs { -1.0 }; //Set when the work timed its core itself, leaving out its upkeep.
+
+	BenchCount(std::size_t mOperations, std::size_t mHits = 0, double mTimedMs = -1.0) :
+		Operations(mOperations),
+		Hits(mHits),
+		TimedMs(mTimedMs)
+	{}
+};
+
+struct BenchResult
+{
+	std::string Name;
+	std::size_t Entities;
+	std::size_t Operations;
+	std::size_t Hits;
+	double BestMs;
+
+	double NsPerOperation() const noexcept
+	{
+		return Operations > 0 ? BestMs * 1000000.0 / Operations : 0.0;
+	}
+	double OperationsPerSecond() const noexcept
+	{
+		return BestMs > 0.0 ? Operations * 1000.0 / BestMs : 0.0;
+	}
+};
+
+class BenchRunner
+{
+public:
+	//Builds the world and returns the work to time. The work
+	//returns how many operations it did.
+	using Work = std::function<BenchCount()>;
+	using Setup = std::function<Work()>;
+
+private:
+	std::size_t repeats;
+	std::vector<BenchResult> results;
+
+public:
+	explicit BenchRunner(std::size_t mRepeats) :
+		repeats(mRepeats > 0 ? mRepeats : 1)
+	{}
+
+	//Runs 'setup' then its work 'repeats' times. Every run
+	//should count the same, a seeded world always does.
+	void Run(const std::string& name, std::size_t entities, const Setup& setup);
+
+	const std::vector<BenchResult>& GetResults() const noexcept
+	{
+		return results;
+	}
+
+	void WriteJson(std::ostream& out) const;
+	void WriteCsv(std::ostream& out) const;
+};
+
+//Keep the compiler from dropping work whose result is unused.
+void DoNotOptimize(float value);
+
+//Every EntityManager case at 'entityCount' entities.
+void RunEntityManagerBenchmarks(BenchRunner& runner, std::size_t entityCount);
+//Every broadphase on the same wave, one operation is one step.
+void RunBroadphaseBenchmarks(BenchRunner& runner, std::size_t enemyCount);
+//Every AABB kernel this CPU runs, one operation is one box pair.
+void RunAABBKernelBenchmarks(BenchRunner& runner, std::size_t candidateCount);
+//Seeded game scenes through 'CollisionManager', one operation is
+//one broadphase pair and a hit is a contact.
+void RunCollisionBenchmarks(BenchRunner& runner, std::size_t enemyCount);
+//Every particle kernel with the compaction, one operation is one
+//particle moved and a hit is one still alive at the end.
+void RunParticleBenchmarks(BenchRunner& runner, std::size_t particleCount);
@@ -0,0 +1,104 @@
+#include "Bench.h"
+#include "Game/include/GlobalGameSettings.h"
+#include "Game/include/SpatialHash.h"
+#include "Game/include/SweepAndPrune.h"
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace
+{
+constexpr std::size_t WaveSteps { 60 };
+
+using Frames = std::vector<std::vector<BroadphaseProxy>>;
+
+//One second of a wave: enemies close in on a player in the
+//middle of the arena while a stream of projectiles flies out.
+//Computed up front so only the broadphase is timed.
+std::shared_ptr<Frames> MakeWave(std::size_t enemyCount)
+{
+	std::default_random_engine random(42);
+	std::uniform_real_distribution<float> x(0.f, ScreenWidth);
+	std::uniform_real_distribution<float> y(0.f, ScreenHeight);
+	std::uniform_real_distribution<float> angle(0.f, 6.2832f);
+
+	const float half(16.f);
+	const float centerX(ScreenWidth / 2.f);
+	const float centerY(ScreenHeight / 2.f);
+	const std::uint32_t enemyMask((1u << EntityGroup::Player) | (1u << EntityGroup::Projectile));
+
+	std::vector<float> enemyX, enemyY;
+	for (std::size_t i = 0; i < enemyCount; ++i)
+	{
+		enemyX.emplace_back(x(random));
+		enemyY.emplace_back(y(random));
+	}
+
+	struct Shot
+	{
+		float X, Y, DX, DY;
+	};
+	std::vector<Shot> shots;
+
+	auto frames(std::make_shared<Frames>());
+	for (std::size_t step = 0; step < WaveSteps; ++step)
+	{
+		std::vector<BroadphaseProxy> proxies;
+		proxies.emplace_back(BroadphaseProxy { AABB { centerX - half, centerY - half, centerX + half, centerY + half }, 1u << EntityGroup::Player, 0 });
+
+		for (std::size_t i = 0; i < enemyCount; ++i)
+		{
+			const float dx(centerX - enemyX[i]);
+			const float dy(centerY - enemyY[i]);
+			const float length(std::sqrt(dx * dx + dy * dy) + 0.001f);
+			enemyX[i] += dx / length * 2.f;
+			enemyY[i] += dy / length * 2.f;
+			proxies.emplace_back(BroadphaseProxy { AABB { enemyX[i] - half, enemyY[i] - half, enemyX[i] + half, enemyY[i] + half }, 1u << EntityGroup::Enemy, enemyMask });
+		}
+
+		//Fire every few steps, drop shots that left the arena.
+		if (step % 4 == 0)
+		{
+			const float a(angle(random));
+			shots.emplace_back(Shot { centerX, centerY, std::cos(a) * 6.f, std::sin(a) * 6.f });
+		}
+		for (auto& s : shots)
+		{
+			s.X += s.DX;
+			s.Y += s.DY;
+			proxies.emplace_back(BroadphaseProxy { AABB { s.X - 4.f, s.Y - 4.f, s.X + 4.f, s.Y + 4.f }, 1u << EntityGroup::Projectile, 0 });
+		}
+
+		frames->emplace_back(std::move(proxies));
+	}
+	return frames;
+}
+
+void RunWave(BenchRunner& runner, const std::string& name, std::size_t enemyCount, std::function<std::unique_ptr<Broadphase>()> make)
+{
+	runner.Run(name, enemyCount, [enemyCount, make]() -> BenchRunner::Work {
+		auto frames(MakeWave(enemyCount));
+		std::shared_ptr<Broadphase> broadphase(make());
+		return [frames, broadphase]() {
+			std::size_t pairs { 0 };
+			for (auto& proxies : *frames)
+			{
+				broadphase->Update(proxies);
+				pairs += broadphase->GetPairs().size();
+			}
+			DoNotOptimize(static_cast<float>(pairs));
+			return frames->size();
+		};
+	});
+}
+}
+
+void RunBroadphaseBenchmarks(BenchRunner& runner, std::size_t enemyCount)
+{
+	RunWave(runner, "Broadphase/spatial-hash", enemyCount, []() {
+		return std::make_unique<SpatialHash>(CollisionCellSize);
+	});
+	RunWave(runner, "Broadphase/sweep-and-prune", enemyCount, []() {
+		return std::make_unique<SweepAndPrune>();
+	});
+}
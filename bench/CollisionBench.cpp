@@ -0,0 +1,142 @@
+#include "Bench.h"
+#include "Game/include/CollisionManager.h"
+#include "Game/include/Components.h"
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+
+using namespace ComponentSystem;
+
+namespace
+{
+constexpr std::size_t SceneTicks { 120 };
+constexpr float SceneStep { 1.f / 60.f };
+constexpr unsigned SceneSeed { 42 };
+
+//What a scene holds, built the same way every run.
+struct CollisionScene
+{
+	const char* Name;
+	std::array<std::size_t, 4> Enemies; //How many of each 'EnemyMoveType'.
+	std::size_t Projectiles;            //Kept in the air, fired again when gone.
+	std::size_t Obstacles;
+};
+
+//The game without a window: no sprites, no input, a player
+//that does not move or die and a weapon that fires at random.
+class SceneWorld
+{
+private:
+	EntityManager manager;
+	eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies> dispatcher;
+	CollisionManager collisionManager { manager, dispatcher };
+	std::default_random_engine random { SceneSeed };
+	EntityHandle player;
+	std::size_t projectiles { 0 };
+
+public:
+	SceneWorld(const CollisionScene& scene, BroadphaseType type) :
+		projectiles(scene.Projectiles)
+	{
+		collisionManager.SetBroadphase(type);
+		std::uniform_real_distribution<float> x(0.f, ScreenWidth);
+		std::uniform_real_distribution<float> y(0.f, ScreenHeight);
+
+		auto& p(manager.AddEntity(GetComponentBitset<CTransform, CPhysics, CStat, CPlayerControl>()));
+		p.AddComponent<CTransform>(sf::Vector2f(ScreenWidth / 2.f, ScreenHeight / 2.f));
+		p.AddComponent<CPhysics>(sf::Vector2f(16.f, 16.f), ScreenWidth, ScreenHeight);
+		p.AddComponent<CStat>(1000000, 1.f, dispatcher);
+		p.AddComponent<CPlayerControl>(PlayerBaseSpeed).Stop = true;
+		p.AddGroup(EntityGroup::Player);
+		player = p.GetHandle();
+
+		for (std::size_t i = 0; i < scene.Obstacles; ++i)
+		{
+			auto& e(manager.AddEntity(GetComponentBitset<CTransform, CPhysics>()));
+			e.AddComponent<CTransform>(sf::Vector2f(x(random), y(random)));
+			e.AddComponent<CPhysics>(sf::Vector2f(24.f, 24.f), ScreenWidth, ScreenHeight);
+			e.AddGroup(EntityGroup::Obstacle);
+		}
+
+		for (std::size_t type = 0; type < scene.Enemies.size(); ++type)
+		{
+			for (std::size_t i = 0; i < scene.Enemies[type]; ++i)
+			{
+				auto& e(manager.AddEntity(GetComponentBitset<CTransform, CPhysics, CStat, CSimpleEnemyControl>()));
+				e.AddComponent<CTransform>(sf::Vector2f(x(random), y(random)));
+				e.AddComponent<CPhysics>(sf::Vector2f(16.f, 16.f), ScreenWidth, ScreenHeight);
+				e.AddComponent<CStat>(EnemyBaseHealth, 1.f, dispatcher);
+				e.AddComponent<CSimpleEnemyControl>(EnemyBaseSpeed, player, static_cast<EnemyMoveType>(type));
+				e.AddGroup(EntityGroup::Enemy);
+			}
+		}
+		Refill();
+	}
+
+	//One fixed step of the game, only the collision test is timed.
+	void Step(std::size_t& pairs, std::size_t& hits, double& ms)
+	{
+		Refill();
+		manager.Refresh();
+		manager.Update(SceneStep);
+
+		const auto start(std::chrono::steady_clock::now());
+		collisionManager.TestAllCollision();
+		const std::chrono::duration<double, std::milli> elapsed(std::chrono::steady_clock::now() - start);
+
+		ms += elapsed.count();
+		pairs += collisionManager.GetBroadphaseStats().Pairs;
+		hits += collisionManager.GetContacts().GetContacts().size();
+	}
+
+private:
+	void Refill()
+	{
+		std::uniform_real_distribution<float> angle(0.f, 6.2832f);
+		const sf::Vector2f from(manager.GetEntity(player).GetComponent<CTransform>().Position);
+		for (std::size_t i = manager.GetEntitiesByGroup(EntityGroup::Projectile).size(); i < projectiles; ++i)
+		{
+			const float a(angle(random));
+			auto& e(manager.AddEntity(GetComponentBitset<CTransform, CPhysics, CProjectile>()));
+			e.AddComponent<CTransform>(from);
+			e.AddComponent<CPhysics>(sf::Vector2f(4.f, 4.f), ScreenWidth, ScreenHeight).Continuous = true;
+			e.AddComponent<CProjectile>(BulletBaseSpeed, sf::Vector2f(std::cos(a), std::sin(a)), 1);
+			e.AddGroup(EntityGroup::Projectile);
+		}
+	}
+};
+
+void RunScene(BenchRunner& runner, const CollisionScene& scene, std::size_t enemyCount, const char* broadphaseName, BroadphaseType type)
+{
+	runner.Run(std::string("Collision/") + scene.Name + "/" + broadphaseName, enemyCount, [scene, type]() -> BenchRunner::Work {
+		auto world(std::make_shared<SceneWorld>(scene, type));
+		return [world]() {
+			std::size_t pairs { 0 };
+			std::size_t hits { 0 };
+			double ms { 0.0 };
+			for (std::size_t tick = 0; tick < SceneTicks; ++tick)
+				world->Step(pairs, hits, ms);
+			return BenchCount(pairs, hits, ms);
+		};
+	});
+}
+}
+
+void RunCollisionBenchmarks(BenchRunner& runner, std::size_t enemyCount)
+{
+	const std::size_t quarter(enemyCount / 4);
+	const std::size_t projectiles(enemyCount / 4 + 8);
+	const CollisionScene scenes[] {
+		//Everything closes in on the player.
+		{ "chasers", { enemyCount, 0, 0, 0 }, projectiles, 0 },
+		//Every move type among the rocks of a level.
+		{ "mixed", { quarter, quarter, quarter, enemyCount - 3 * quarter }, projectiles, 10 },
+	};
+
+	for (auto& scene : scenes)
+	{
+		RunScene(runner, scene, enemyCount, "spatial-hash", BroadphaseType::SpatialHash);
+		RunScene(runner, scene, enemyCount, "sweep-and-prune", BroadphaseType::SweepAndPrune);
+	}
+}
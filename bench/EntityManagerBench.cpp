@@ -0,0 +1,115 @@
+#include "Bench.h"
+#include "ComponentSystem/EntityManager.h"
+#include "ComponentSystem/View.h"
+#include "Game/include/Components.h"
+
+using namespace ComponentSystem;
+
+namespace
+{
+using Manager = std::shared_ptr<EntityManager>;
+
+void AddTestEntity(EntityManager& manager, const ComponentBitset& signature, std::size_t i)
+{
+	auto& e(signature.any() ? manager.AddEntity(signature) : manager.AddEntity());
+	e.AddComponent<CTransform>(sf::Vector2f(static_cast<float>(i), 0.f));
+	e.AddComponent<CCounter>().Counter = 0.f;
+
+	//Every other entity goes to a group, like enemies
+	//sharing the world with projectiles and obstacles.
+	if (i % 2 == 0)
+		e.AddGroup(0);
+}
+
+Manager MakeWorld(std::size_t entityCount)
+{
+	auto manager(std::make_shared<EntityManager>());
+	const auto signature(GetComponentBitset<CTransform, CCounter>());
+	for (std::size_t i = 0; i < entityCount; ++i)
+		AddTestEntity(*manager, signature, i);
+	return manager;
+}
+}
+
+void RunEntityManagerBenchmarks(BenchRunner& runner, std::size_t entityCount)
+{
+	runner.Run("AddEntity/archetype", entityCount, [entityCount]() -> BenchRunner::Work {
+		auto manager(std::make_shared<EntityManager>());
+		return [manager, entityCount]() {
+			const auto signature(GetComponentBitset<CTransform, CCounter>());
+			for (std::size_t i = 0; i < entityCount; ++i)
+				AddTestEntity(*manager, signature, i);
+			return entityCount;
+		};
+	});
+
+	runner.Run("AddEntity/loose", entityCount, [entityCount]() -> BenchRunner::Work {
+		auto manager(std::make_shared<EntityManager>());
+		return [manager, entityCount]() {
+			for (std::size_t i = 0; i < entityCount; ++i)
+				AddTestEntity(*manager, ComponentBitset(), i);
+			return entityCount;
+		};
+	});
+
+	runner.Run("GetComponent", entityCount, [entityCount]() -> BenchRunner::Work {
+		auto manager(MakeWorld(entityCount));
+		return [manager]() {
+			float sum { 0.f };
+			for (auto& e : manager->GetEntities())
+				sum += e->GetComponent<CTransform>().Position.x;
+			DoNotOptimize(sum);
+			return manager->GetEntities().size();
+		};
+	});
+
+	runner.Run("Update", entityCount, [entityCount]() -> BenchRunner::Work {
+		auto manager(MakeWorld(entityCount));
+		return [manager]() {
+			manager->Update(1.f / 60.f);
+			return manager->GetEntities().size();
+		};
+	});
+
+	runner.Run("Refresh/destroy-half", entityCount, [entityCount]() -> BenchRunner::Work {
+		auto manager(MakeWorld(entityCount));
+		return [manager]() {
+			//Destroying is part of the cost, it only marks.
+			const auto& entities(manager->GetEntities());
+			std::vector<GameEntity*> doomed;
+			for (std::size_t i = 0; i < entities.size(); i += 2)
+				doomed.emplace_back(entities[i]);
+			for (auto& e : doomed)
+				manager->DestroyEntity(*e);
+
+			manager->Refresh();
+			return doomed.size();
+		};
+	});
+
+	runner.Run("Group/iterate", entityCount, [entityCount]() -> BenchRunner::Work {
+		auto manager(MakeWorld(entityCount));
+		return [manager]() {
+			float sum { 0.f };
+			auto& group(manager->GetEntitiesByGroup(0));
+			for (auto& handle : group)
+				sum += manager->GetEntity(handle).GetComponent<CTransform>().Position.x;
+			DoNotOptimize(sum);
+			return group.size();
+		};
+	});
+
+	runner.Run("View/iterate", entityCount, [entityCount]() -> BenchRunner::Work {
+		auto manager(MakeWorld(entityCount));
+		return [manager]() {
+			float sum { 0.f };
+			std::size_t visited { 0 };
+			manager->View<CTransform, CCounter>().ForEach([&sum, &visited](GameEntity&, CTransform& mTransform, CCounter&) {
+				sum += mTransform.Position.x;
+				++visited;
+			});
+			DoNotOptimize(sum);
+			return visited;
+		};
+	});
+}
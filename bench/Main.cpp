@@ -0,0 +1,92 @@
+#include "Bench.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+/////////////////////////////////////////////////
+///Headless benchmarks, build with 'BUILD=Bench'.
+///
+///  --csv          write CSV instead of JSON
+///  --out <file>   write results to a file, not stdout
+///  --max <count>  skip sizes above 'count' entities
+///  --repeat <n>   runs per case, the best is kept
+/////////////////////////////////////////////////
+int main(const int argc, const char* argv[])
+{
+	bool csv { false };
+	std::string outPath;
+	std::size_t maxEntities { 1000000 };
+	std::size_t repeats { 5 };
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool hasValue(i + 1 < argc);
+		if (std::strcmp(argv[i], "--csv") == 0)
+			csv = true;
+		else if (std::strcmp(argv[i], "--out") == 0 && hasValue)
+			outPath = argv[++i];
+		else if (std::strcmp(argv[i], "--max") == 0 && hasValue)
+			maxEntities = std::stoul(argv[++i]);
+		else if (std::strcmp(argv[i], "--repeat") == 0 && hasValue)
+			repeats = std::stoul(argv[++i]);
+		else
+		{
+			std::cerr << "Unknown option " << argv[i] << std::endl;
+			return 1;
+		}
+	}
+
+	BenchRunner runner(repeats);
+	for (std::size_t count : { 1000u, 10000u, 100000u, 1000000u })
+	{
+		if (count <= maxEntities)
+			RunEntityManagerBenchmarks(runner, count);
+	}
+
+	//From a late wave in the arena to a much bigger world.
+	for (std::size_t count : { 60u, 600u, 6000u })
+	{
+		if (count <= maxEntities)
+			RunBroadphaseBenchmarks(runner, count);
+	}
+
+	//What a sweep or a cell holds, up to a crowded one.
+	for (std::size_t count : { 16u, 256u, 4096u })
+	{
+		if (count <= maxEntities)
+			RunAABBKernelBenchmarks(runner, count);
+	}
+
+	//A wave, a late wave and far more than the arena holds.
+	for (std::size_t count : { 40u, 400u, 4000u })
+	{
+		if (count <= maxEntities)
+			RunCollisionBenchmarks(runner, count);
+	}
+
+	//Many bursts at once, up to far more than the pool holds.
+	for (std::size_t count : { 10000u, 100000u, 1000000u })
+	{
+		if (count <= maxEntities)
+			RunParticleBenchmarks(runner, count);
+	}
+
+	std::ofstream file;
+	if (!outPath.empty())
+	{
+		file.open(outPath);
+		if (!file)
+		{
+			std::cerr << "Error! Can not write " << outPath << std::endl;
+			return 1;
+		}
+	}
+
+	std::ostream& out(outPath.empty() ? std::cout : file);
+	if (csv)
+		runner.WriteCsv(out);
+	else
+		runner.WriteJson(out);
+
+	return 0;
+}
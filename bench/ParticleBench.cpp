@@ -0,0 +1,64 @@
+#include "Bench.h"
+#include "Game/include/ParticleKernel.h"
+#include "Game/include/GlobalGameSettings.h"
+#include "Utility/BitMask.hpp"
+#include <memory>
+#include <random>
+
+namespace
+{
+constexpr std::size_t ParticleSteps { 10 };
+constexpr float ParticleStep { 1.f / 60.f };
+
+//Hit effects all over the screen, a third fading out
+//within the run and a few flying off it.
+ParticleBatch MakeParticles(std::size_t count, unsigned seed)
+{
+	std::default_random_engine random(seed);
+	std::uniform_real_distribution<float> x(0.f, ScreenWidth);
+	std::uniform_real_distribution<float> y(0.f, ScreenHeight);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+	std::uniform_real_distribution<float> fade(0.f, 30.f);
+
+	ParticleBatch batch;
+	batch.Reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		batch.Add(Particle { sf::Vector2f(x(random), y(random)), sf::Vector2f(unit(random), unit(random)),
+			sf::Vector2f(unit(random) * 5.f, unit(random) * 5.f), 100.f, i % 3 == 0 ? fade(random) : 0.f, sf::Color::Red });
+	}
+	return batch;
+}
+}
+
+void RunParticleBenchmarks(BenchRunner& runner, std::size_t particleCount)
+{
+	for (auto type : { ParticleKernelType::Scalar, ParticleKernelType::SSE, ParticleKernelType::AVX2 })
+	{
+		const ParticleKernel kernel(GetParticleKernel(type));
+		if (kernel == nullptr)
+			continue;
+
+		runner.Run(std::string("Particles/") + GetParticleKernelName(type), particleCount, [kernel, particleCount]() -> BenchRunner::Work {
+			auto start(std::make_shared<const ParticleBatch>(MakeParticles(particleCount, 3)));
+			auto batch(std::make_shared<ParticleBatch>(*start));
+			auto alive(std::make_shared<std::vector<std::uint64_t>>());
+			return [kernel, start, batch, alive]() {
+				//Every run starts from the same particles, copying
+				//them back is not timed.
+				*batch = *start;
+				std::size_t moved { 0 };
+				const auto begin(std::chrono::steady_clock::now());
+				for (std::size_t step = 0; step < ParticleSteps; ++step)
+				{
+					moved += batch->Size();
+					alive->resize(util::GetHitWords(batch->Size()));
+					kernel(*batch, ParticleStep, alive->data());
+					CompactParticles(*batch, *alive);
+				}
+				const std::chrono::duration<double, std::milli> elapsed(std::chrono::steady_clock::now() - begin);
+				return BenchCount(moved, batch->Size(), elapsed.count());
+			};
+		});
+	}
+}
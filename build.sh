@@ -72,12 +72,12 @@ cmd_buildrun() {
 	display_styled_symbol 33 "⬤" "Build & Run: $BUILD (target: $NAME)"
 	printf '\n'
 	BLD=$BUILD
-	if [[ $BUILD == 'Tests' && $1 != 'main' ]]; then
+	if [[ ($BUILD == 'Tests' || $BUILD == 'Bench') && $1 != 'main' ]]; then
 		BLD=Release
 	fi
 	if $MAKE_EXEC BUILD=$BLD; then
 		build_success_launch
-		if [[ $BUILD == 'Tests' ]]; then
+		if [[ $BUILD == 'Tests' || $BUILD == 'Bench' ]]; then
 			bin/Release/$NAME $OPTIONS
 		else
 			bin/$BUILD/$NAME $OPTIONS
@@ -91,7 +91,7 @@ cmd_build() {
 	display_styled_symbol 33 "⬤" "Build: $BUILD (target: $NAME)"
 	printf '\n'
 	BLD=$BUILD
-	if [[ $BUILD == 'Tests' && $1 != 'main' ]]; then
+	if [[ ($BUILD == 'Tests' || $BUILD == 'Bench') && $1 != 'main' ]]; then
 		BLD=Release
 	fi
 	if $MAKE_EXEC BUILD=$BLD; then
@@ -105,7 +105,7 @@ cmd_rebuild() {
 	display_styled_symbol 33 "⬤" "Rebuild: $BUILD (target: $NAME)"
 	printf '\n'
 	BLD=$BUILD
-	if [[ $BUILD == 'Tests' && $1 != 'main' ]]; then
+	if [[ ($BUILD == 'Tests' || $BUILD == 'Bench') && $1 != 'main' ]]; then
 		BLD=Release
 	fi
 	if $MAKE_EXEC BUILD=$BLD rebuild; then
@@ -119,7 +119,7 @@ cmd_run() {
 	display_styled_symbol 33 "⬤" "Run: $BUILD (target: $NAME)"
 	printf '\n'
 	launch
-	if [[ $BUILD == 'Tests' ]]; then
+	if [[ $BUILD == 'Tests' || $BUILD == 'Bench' ]]; then
 		bin/Release/$NAME $OPTIONS
 	else
 		bin/$BUILD/$NAME $OPTIONS
@@ -209,7 +209,7 @@ if [[ $PLATFORM == 'windows' ]]; then
 	fi
 fi
 
-if [[ $BUILD != "Release" && $BUILD != 'Debug' && $BUILD != 'Tests' ]]; then
+if [[ $BUILD != "Release" && $BUILD != 'Debug' && $BUILD != 'Tests' && $BUILD != 'Bench' ]]; then
 	BUILD=Release
 fi
 
@@ -230,6 +230,8 @@ for target in $BUILD_TARGETS; do
 			export NAME=$cwd.exe
 			if [[ $BUILD == 'Tests' ]]; then
 				NAME=tests_$NAME
+			elif [[ $BUILD == 'Bench' ]]; then
+				NAME=bench_$NAME
 			fi
 		else
 			if [[ $BUILD == 'Debug' ]]; then
@@ -244,6 +246,8 @@ for target in $BUILD_TARGETS; do
 				export NAME=$cwd
 				if [[ $BUILD == 'Tests' ]]; then
 					NAME=tests_$NAME
+				elif [[ $BUILD == 'Bench' ]]; then
+					NAME=bench_$NAME
 				fi
 			else
 				if [[ $BUILD == 'Debug' ]]; then
@@ -257,6 +261,8 @@ for target in $BUILD_TARGETS; do
 				export NAME=$cwd
 				if [[ $BUILD == 'Tests' ]]; then
 					NAME=tests_$NAME
+				elif [[ $BUILD == 'Bench' ]]; then
+					NAME=bench_$NAME
 				fi
 			else
 				if [[ $BUILD == 'Debug' ]]; then
@@ -0,0 +1,83 @@
+#include "Archetype.h"
+
+namespace ComponentSystem
+{
+
+ComponentColumn::~ComponentColumn()
+{
+	for (std::size_t row = 0; row < constructed.size(); ++row)
+		Destroy(row);
+
+	for (auto& chunk : chunks)
+		upstream->deallocate(chunk, ChunkRows * stride, alignment);
+	stats.SlabBytes -= chunks.size() * ChunkRows * stride;
+}
+
+void* ComponentColumn::Slot(std::size_t row)
+{
+	//Grow chunk by chunk, old chunks never move.
+	while (chunks.size() <= row / ChunkRows)
+	{
+		void* memory(upstream->allocate(ChunkRows * stride, alignment));
+		chunks.emplace_back(static_cast<unsigned char*>(memory));
+		stats.SlabBytes += ChunkRows * stride;
+	}
+
+	if (constructed.size() <= row)
+		constructed.resize(row + 1, 0);
+
+	return SlotUnchecked(row);
+}
+
+void ComponentColumn::Destroy(std::size_t row) noexcept
+{
+	if (!IsConstructed(row))
+		return;
+
+	constructed[row] = 0;
+	destroy(SlotUnchecked(row));
+	stats.OnDeallocate();
+}
+
+std::size_t Archetype::AllocateRow(GameEntity* entity)
+{
+	std::size_t row;
+	if (!freeRows.empty())
+	{
+		//Reuse a hole so the columns stay dense.
+		row = freeRows.back();
+		freeRows.pop_back();
+		rows[row] = entity;
+	}
+	else
+	{
+		row = rows.size();
+		rows.emplace_back(entity);
+	}
+
+	++liveRows;
+	return row;
+}
+
+void Archetype::FreeRow(std::size_t row) noexcept
+{
+	for (auto& c : columns)
+		c->Destroy(row);
+
+	rows[row] = nullptr;
+	freeRows.emplace_back(row);
+	--liveRows;
+}
+
+void Archetype::Update(float mFT, const ComponentBitset& skip)
+{
+	//One column at a time, so each loop runs the same
+	//'Update' over memory that sits next to each other.
+	for (std::size_t i = 0; i < columns.size(); ++i)
+	{
+		if (!skip[columns[i]->GetID()])
+			columns[i]->Update(mFT);
+	}
+}
+
+}
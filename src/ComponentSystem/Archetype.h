@@ -0,0 +1,245 @@
+#pragma once
+#include "ComponentSystemDefine.h"
+#include "PoolAllocator.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/////////////////////////////////////////////////
+///This file is for Archetype that packs components
+///of entities sharing the same ComponentBitset into
+///contiguous per-type columns.
+///
+///Columns are split into fixed-size chunks so a
+///component never moves once it is constructed.
+///Components cache pointers to each other in Init(),
+///so stable addresses are a must here.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+/*
+ * Type-erased storage for one component type
+ * inside an Archetype.
+ */
+class ComponentColumn
+{
+public:
+	using DestroyFn = void (*)(void*);
+	using UpdateFn = void (*)(ComponentColumn&, float);
+
+	//How many rows a chunk holds.
+	static constexpr std::size_t ChunkRows { 64 };
+
+private:
+	ComponentID id;
+	std::size_t stride;
+	std::size_t alignment;
+	DestroyFn destroy;
+	UpdateFn update;
+
+	//Chunks come from the same upstream resource as the
+	//component pools and count towards the same stats.
+	std::pmr::memory_resource* upstream;
+	PoolStats& stats;
+
+	std::vector<unsigned char*> chunks;
+	std::vector<unsigned char> constructed;
+
+public:
+	ComponentColumn(ComponentID mID, std::size_t mStride, std::size_t mAlignment, DestroyFn mDestroy, UpdateFn mUpdate,
+		std::pmr::memory_resource* mUpstream, PoolStats& mStats) :
+		id(mID),
+		stride(mStride),
+		alignment(mAlignment),
+		destroy(mDestroy),
+		update(mUpdate),
+		upstream(mUpstream),
+		stats(mStats)
+	{}
+	~ComponentColumn();
+
+	ComponentColumn(const ComponentColumn&) = delete;
+	ComponentColumn& operator=(const ComponentColumn&) = delete;
+
+	ComponentID GetID() const noexcept
+	{
+		return id;
+	}
+
+	std::size_t Size() const noexcept
+	{
+		return constructed.size();
+	}
+
+	bool IsConstructed(std::size_t row) const noexcept
+	{
+		return row < constructed.size() && constructed[row] != 0;
+	}
+
+	//Raw memory of the row, allocating the chunk if needed.
+	void* Slot(std::size_t row);
+
+	//Raw memory of a row that is known to exist.
+	void* SlotUnchecked(std::size_t row) const noexcept
+	{
+		return chunks[row / ChunkRows] + (row % ChunkRows) * stride;
+	}
+
+	void MarkConstructed(std::size_t row) noexcept
+	{
+		constructed[row] = 1;
+		stats.OnAllocate();
+	}
+
+	void Destroy(std::size_t row) noexcept;
+
+	void Update(float mFT)
+	{
+		if (update != nullptr)
+			update(*this, mFT);
+	}
+
+	std::size_t ChunkCount() const noexcept
+	{
+		return (constructed.size() + ChunkRows - 1) / ChunkRows;
+	}
+
+	//Visit every constructed component, one chunk at a time.
+	template <typename T, typename F>
+	void ForEach(F&& mFunc);
+	//Visit the constructed components of one chunk.
+	template <typename T, typename F>
+	void ForEachInChunk(std::size_t chunk, F&& mFunc);
+
+	template <typename T>
+	static std::unique_ptr<ComponentColumn> Create(ComponentID mID, std::pmr::memory_resource* mUpstream, PoolStats& mStats);
+};
+
+/*
+ * An Archetype owns all entities with the same
+ * ComponentBitset. Each entity takes one row and
+ * each component type in the signature one column.
+ */
+class Archetype
+{
+private:
+	ComponentBitset signature;
+	std::pmr::memory_resource* upstream;
+	std::array<PoolStats, MaxComponents>& componentStats;
+
+	//Lookup by ComponentID, plus the order columns were
+	//created in so updates keep the per-entity order.
+	std::array<std::unique_ptr<ComponentColumn>, MaxComponents> columnsByID;
+	std::vector<ComponentColumn*> columns;
+
+	std::vector<GameEntity*> rows;
+	std::vector<std::size_t> freeRows;
+	std::size_t liveRows { 0 };
+
+public:
+	Archetype(const ComponentBitset& mSignature, std::pmr::memory_resource* mUpstream, std::array<PoolStats, MaxComponents>& mStats) :
+		signature(mSignature),
+		upstream(mUpstream),
+		componentStats(mStats)
+	{}
+
+	const ComponentBitset& GetSignature() const noexcept
+	{
+		return signature;
+	}
+
+	bool Stores(ComponentID id) const noexcept
+	{
+		return signature[id];
+	}
+
+	std::size_t Size() const noexcept
+	{
+		return liveRows;
+	}
+
+	//Owner of each row, nullptr for a freed row.
+	const std::vector<GameEntity*>& GetRows() const noexcept
+	{
+		return rows;
+	}
+
+	std::size_t AllocateRow(GameEntity* entity);
+	void FreeRow(std::size_t row) noexcept;
+
+	ComponentColumn* GetColumn(ComponentID id) const noexcept
+	{
+		return columnsByID[id].get();
+	}
+
+	template <typename T, typename... TArgs>
+	T* Emplace(ComponentID id, std::size_t row, TArgs&&... mArgs);
+
+	//Components in 'skip' are left to their System.
+	void Update(float mFT, const ComponentBitset& skip);
+};
+
+template <typename T, typename F>
+void ComponentColumn::ForEach(F&& mFunc)
+{
+	const std::size_t count(ChunkCount());
+	for (std::size_t chunk = 0; chunk < count; ++chunk)
+		ForEachInChunk<T>(chunk, mFunc);
+}
+
+template <typename T, typename F>
+void ComponentColumn::ForEachInChunk(std::size_t chunk, F&& mFunc)
+{
+	const std::size_t begin(chunk * ChunkRows);
+	const std::size_t end(std::min(begin + ChunkRows, constructed.size()));
+	T* components(reinterpret_cast<T*>(chunks[chunk]));
+
+	for (std::size_t row = begin; row < end; ++row)
+	{
+		if (constructed[row] != 0)
+			mFunc(components[row - begin]);
+	}
+}
+
+template <typename T>
+std::unique_ptr<ComponentColumn> ComponentColumn::Create(ComponentID mID, std::pmr::memory_resource* mUpstream, PoolStats& mStats)
+{
+	DestroyFn destroyFn = [](void* mSlot) {
+		static_cast<T*>(mSlot)->~T();
+	};
+
+	//Taking '&T::Update' gives a 'Component' member pointer
+	//when T does not override it, so there is nothing to run.
+	UpdateFn updateFn { nullptr };
+	if constexpr (!std::is_same<decltype(&T::Update), void (Component::*)(float)>::value)
+	{
+		updateFn = [](ComponentColumn& mColumn, float mFT) {
+			//Qualified call so the compiler skips the vtable.
+			mColumn.ForEach<T>([mFT](T& c) {
+				c.T::Update(mFT);
+			});
+		};
+	}
+
+	return std::make_unique<ComponentColumn>(mID, sizeof(T), alignof(T), destroyFn, updateFn, mUpstream, mStats);
+}
+
+template <typename T, typename... TArgs>
+T* Archetype::Emplace(ComponentID id, std::size_t row, TArgs&&... mArgs)
+{
+	auto& column(columnsByID[id]);
+	if (column == nullptr)
+	{
+		column = ComponentColumn::Create<T>(id, upstream, componentStats[id]);
+		columns.emplace_back(column.get());
+	}
+
+	T* c(new (column->Slot(row)) T(std::forward<TArgs>(mArgs)...));
+	column->MarkConstructed(row);
+	return c;
+}
+
+}
@@ -0,0 +1,84 @@
+#include "CommandBuffer.h"
+#include "EntityManager.h"
+
+namespace ComponentSystem
+{
+
+void CommandBuffer::Record(Command&& command)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	commands.emplace_back(std::move(command));
+}
+
+void CommandBuffer::Create(const ComponentBitset& signature, BuildFn build)
+{
+	Record(Command { CommandType::Create, NullEntity, signature, 0, std::move(build) });
+}
+
+void CommandBuffer::Destroy(EntityHandle handle)
+{
+	Record(Command { CommandType::Destroy, handle, ComponentBitset {}, 0, nullptr });
+}
+
+void CommandBuffer::AddGroup(EntityHandle handle, Group group)
+{
+	Record(Command { CommandType::AddGroup, handle, ComponentBitset {}, group, nullptr });
+}
+
+bool CommandBuffer::IsEmpty()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return commands.empty();
+}
+
+void CommandBuffer::Clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	commands.clear();
+}
+
+void CommandBuffer::Apply(EntityManager& manager)
+{
+	//Applying can record more commands, e.g. a component
+	//spawning something in 'Init()', so loop until done.
+	while (!IsEmpty())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			applying.swap(commands);
+		}
+
+		for (auto& c : applying)
+		{
+			if (c.Type == CommandType::Create)
+			{
+				auto& e(manager.AddEntity(c.Signature));
+				if (c.Build)
+					c.Build(e);
+				continue;
+			}
+
+			GameEntity* e(manager.TryGetEntity(c.Handle));
+			if (e == nullptr)
+				continue;
+
+			switch (c.Type)
+			{
+				case CommandType::Destroy:
+					manager.DestroyEntity(*e);
+					break;
+				case CommandType::Build:
+					c.Build(*e);
+					break;
+				case CommandType::AddGroup:
+					e->AddGroup(c.TargetGroup);
+					break;
+				default:
+					break;
+			}
+		}
+		applying.clear();
+	}
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "ComponentSystemDefine.h"
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/////////////////////////////////////////////////
+///This file defines CommandBuffer that records
+///structural changes of entities.
+///
+///Creating or destroying entities and adding
+///components or groups while someone iterates the
+///entities or a group is not safe. Record them here
+///instead, the EntityManager applies them in order
+///at the start of Refresh().
+///
+///Recording is guarded by a mutex so Systems running
+///on other threads can record too.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+class CommandBuffer
+{
+public:
+	//Runs on the entity once the command is applied.
+	using BuildFn = std::function<void(GameEntity&)>;
+
+private:
+	enum class CommandType
+	{
+		Create,
+		Destroy,
+		Build,
+		AddGroup
+	};
+
+	struct Command
+	{
+		CommandType Type;
+		EntityHandle Handle;
+		ComponentBitset Signature;
+		Group TargetGroup;
+		BuildFn Build;
+	};
+
+	std::mutex mutex;
+	std::vector<Command> commands;
+	//Swapped with 'commands' while applying, so commands
+	//recorded by the applied ones wait for the next round.
+	std::vector<Command> applying;
+
+	void Record(Command&& command);
+
+public:
+	//New entity packed in the Archetype of 'signature',
+	//'build' adds its components and groups.
+	void Create(const ComponentBitset& signature, BuildFn build);
+	void Destroy(EntityHandle handle);
+	void AddGroup(EntityHandle handle, Group group);
+
+	//Arguments are copied until the command is applied,
+	//wrap references with 'std::ref'.
+	template <typename T, typename... TArgs>
+	void AddComponent(EntityHandle handle, TArgs&&... mArgs);
+
+	bool IsEmpty();
+	//Drop every pending command.
+	void Clear();
+
+	//Apply every command in the order they were recorded.
+	//Commands on a stale handle are dropped.
+	void Apply(EntityManager& manager);
+};
+
+template <typename T, typename... TArgs>
+void CommandBuffer::AddComponent(EntityHandle handle, TArgs&&... mArgs)
+{
+	//'auto&' so 'GameEntity' only has to be complete
+	//where this is called.
+	BuildFn build = [args = std::make_tuple(std::forward<TArgs>(mArgs)...)](auto& mEntity) mutable {
+		std::apply([&mEntity](auto&&... mValues) {
+			mEntity.template AddComponent<T>(std::forward<decltype(mValues)>(mValues)...);
+		},
+			std::move(args));
+	};
+
+	Record(Command { CommandType::Build, handle, ComponentBitset {}, 0, std::move(build) });
+}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "ComponentSystemDefine.h"
+#include <type_traits>
+
+/////////////////////////////////////////////////
+///This file is the registry of component types.
+///
+///Every component listed in 'RegisteredComponents'
+///gets its ComponentID at compile time, its index
+///in the list. Components not listed still work,
+///they get an ID at runtime after the listed ones.
+///
+///Add new components of the game to the list so
+///'GetComponentTypeID()' costs nothing for them.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+template <typename... Ts>
+struct TypeList
+{
+	static constexpr std::size_t Size { sizeof...(Ts) };
+};
+
+//hide this implementation detail.
+namespace Internal
+{
+template <typename T, typename TList>
+struct IndexOf;
+
+template <typename T, typename... Ts>
+struct IndexOf<T, TypeList<T, Ts...>> : std::integral_constant<std::size_t, 0>
+{};
+
+template <typename T, typename U, typename... Ts>
+struct IndexOf<T, TypeList<U, Ts...>> : std::integral_constant<std::size_t, 1 + IndexOf<T, TypeList<Ts...>>::value>
+{};
+
+template <typename T, typename TList>
+struct Contains;
+
+template <typename T, typename... Ts>
+struct Contains<T, TypeList<Ts...>> : std::bool_constant<(std::is_same<T, Ts>::value || ...)>
+{};
+}
+
+//Components of the game, see 'Game/include/Components.h'.
+struct CCounter;
+struct CTransform;
+struct CSprite2D;
+struct CParticle;
+struct CStat;
+struct CPhysics;
+struct CPlayerControl;
+struct CSimpleEnemyControl;
+struct CProjectile;
+struct CConsumable;
+struct CReceiver;
+
+using RegisteredComponents = TypeList<
+	CCounter,
+	CTransform,
+	CSprite2D,
+	CParticle,
+	CStat,
+	CPhysics,
+	CPlayerControl,
+	CSimpleEnemyControl,
+	CProjectile,
+	CConsumable,
+	CReceiver>;
+
+static_assert(RegisteredComponents::Size <= MaxComponents, "Too many components, raise MaxComponents");
+
+template <typename T>
+constexpr bool IsRegisteredComponent { Internal::Contains<T, RegisteredComponents>::value };
+
+namespace Internal
+{
+//Runtime IDs start right after the registered ones.
+inline ComponentID GetUniqueComponentID() noexcept
+{
+	static ComponentID lastID { RegisteredComponents::Size };
+	return lastID++;
+}
+
+//Everytime we instantiate 'GetRuntimeComponentID()',
+//the static 'lastID' will ++ , making the ID unique.
+template <typename T>
+inline ComponentID GetRuntimeComponentID() noexcept
+{
+	static ComponentID typeID { GetUniqueComponentID() };
+	return typeID;
+}
+}
+
+//Registered components are looked up at compile time,
+//any other type gets its ID the first time it is used.
+template <typename T>
+inline constexpr ComponentID GetComponentTypeID() noexcept
+{
+	if constexpr (IsRegisteredComponent<T>)
+	{
+		return Internal::IndexOf<T, RegisteredComponents>::value;
+	}
+	else
+	{
+		static_assert(std::is_base_of<Component, T>::value,
+			"T must inherit from Component");
+
+		return Internal::GetRuntimeComponentID<T>();
+	}
+}
+
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "EntityHandle.h"
 #include <bitset>
 
 namespace ComponentSystem
@@ -8,6 +9,8 @@ namespace ComponentSystem
 class GameEntity;
 struct Component;
 class EntityManager;
+class SnapshotWriter;
+class SnapshotReader;
 
 using ComponentID = std::size_t;
 using Group = std::size_t;
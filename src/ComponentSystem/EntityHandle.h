@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+/////////////////////////////////////////////////
+///This file defines EntityHandle, a 32-bit
+///index + generation pair that refers to a slot
+///in the EntityManager.
+///
+///Slots are recycled, so a handle goes stale as
+///soon as its entity is freed: the generation of
+///the slot moves on and the old handle no longer
+///matches. Checking that is O(1).
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+struct EntityHandle
+{
+	static constexpr std::uint32_t IndexBits { 20 };
+	static constexpr std::uint32_t GenerationBits { 32 - IndexBits };
+	static constexpr std::uint32_t IndexMask { (1u << IndexBits) - 1u };
+	static constexpr std::uint32_t GenerationMask { (1u << GenerationBits) - 1u };
+
+	//The last index is kept for the null handle.
+	static constexpr std::uint32_t MaxEntities { IndexMask };
+
+	std::uint32_t Value { 0xFFFFFFFFu };
+
+	constexpr EntityHandle() = default;
+	constexpr EntityHandle(std::uint32_t mIndex, std::uint32_t mGeneration) :
+		Value((mIndex & IndexMask) | ((mGeneration & GenerationMask) << IndexBits))
+	{}
+
+	constexpr std::uint32_t Index() const noexcept
+	{
+		return Value & IndexMask;
+	}
+
+	constexpr std::uint32_t Generation() const noexcept
+	{
+		return Value >> IndexBits;
+	}
+
+	constexpr bool IsNull() const noexcept
+	{
+		return Index() == IndexMask;
+	}
+
+	//Same slot, next life.
+	constexpr EntityHandle NextGeneration() const noexcept
+	{
+		return EntityHandle(Index(), Generation() + 1u);
+	}
+};
+
+constexpr bool operator==(EntityHandle a, EntityHandle b) noexcept
+{
+	return a.Value == b.Value;
+}
+
+constexpr bool operator!=(EntityHandle a, EntityHandle b) noexcept
+{
+	return a.Value != b.Value;
+}
+
+constexpr bool operator<(EntityHandle a, EntityHandle b) noexcept
+{
+	return a.Value < b.Value;
+}
+
+constexpr EntityHandle NullEntity {};
+}
+
+namespace std
+{
+template <>
+struct hash<ComponentSystem::EntityHandle>
+{
+	std::size_t operator()(ComponentSystem::EntityHandle mHandle) const noexcept
+	{
+		return std::hash<std::uint32_t>()(mHandle.Value);
+	}
+};
+}
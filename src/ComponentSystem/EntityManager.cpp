@@ -1,58 +1,373 @@
 #include "EntityManager.h"
+#include "System.h"
 
 namespace ComponentSystem
 {
 
+//Blocks per slab, about as many entities as a late wave spawns.
+constexpr std::size_t EntitiesPerSlab { 256 };
+
+namespace
+{
+//Reads the entity table and skips every component block, true
+//if they are all there. Nothing is created.
+bool CheckSnapshotBody(SnapshotReader& reader)
+{
+	const auto count(reader.Read<std::uint32_t>());
+	std::size_t blocks { 0 };
+	for (std::uint32_t i = 0; i < count && reader.IsValid(); ++i)
+	{
+		reader.Read<std::uint32_t>(); //Handle
+		reader.Read<std::uint8_t>();  //Packed
+		reader.Read<std::uint64_t>(); //Signature
+		reader.Read<std::uint64_t>(); //Groups
+
+		const auto idCount(reader.Read<std::uint8_t>());
+		for (std::uint8_t c = 0; c < idCount; ++c)
+		{
+			if (reader.Read<std::uint8_t>() >= MaxComponents)
+				return false;
+		}
+		blocks += idCount;
+	}
+
+	for (std::size_t b = 0; b < blocks && reader.IsValid(); ++b)
+	{
+		const auto size(reader.Read<std::uint32_t>());
+		reader.Seek(reader.GetOffset() + size);
+	}
+	return reader.IsValid();
+}
+}
+
+EntityManager::EntityManager(std::pmr::memory_resource* mUpstream) :
+	upstream(mUpstream),
+	entityPool(sizeof(GameEntity), alignof(GameEntity), EntitiesPerSlab, mUpstream, entityStats)
+{}
+
+EntityManager::~EntityManager()
+{}
+
 void EntityManager::Update(float mFT)
 {
+	if (systems.empty())
+	{
+		UpdateComponents(mFT);
+		return;
+	}
+
+	//Systems can be toggled at any time, a disabled one
+	//hands its components back to the legacy path.
+	systemComponents.reset();
+	for (auto& s : systems)
+	{
+		if (s->Enabled)
+			systemComponents |= s->GetComponents();
+	}
+
+	BuildSystemStages(systems, systemStages);
+	for (auto& stage : systemStages)
+		RunSystemStage(*this, stage, mFT);
+}
+
+void EntityManager::UpdateComponents(float mFT)
+{
+	//Same component type of many entities at a time.
+	for (std::size_t i = 0; i < archetypes.size(); ++i)
+		archetypes[i]->Update(mFT, systemComponents);
+
+	//Then whatever is not stored in an Archetype.
+	if (looseComponentCount == 0)
+		return;
+
 	for (auto& e : entities)
-		e->Update(mFT);
+		e->Update(mFT, systemComponents);
+}
+
+void EntityManager::PushSystem(std::unique_ptr<System> system)
+{
+	systems.emplace_back(std::move(system));
 }
 
-void EntityManager::Render()
+void EntityManager::Render(const ComponentBitset& skip)
 {
 	for (auto& e : entities)
-		e->Render();
+		e->Render(skip);
 }
 
 void EntityManager::Refresh()
 {
-	//Remove dead entities or entities not in the group
-	//from the current group.
-	for (auto i(0u); i < MaxGroups; ++i)
+	//Sync point, nobody is iterating right now.
+	commands.Apply(*this);
+
+	for (auto& e : dirtyEntities)
 	{
-		auto& entitiesInGroup(groupedEntities[i]);
+		const EntityHandle handle(e->handle);
 
-		entitiesInGroup.erase(std::remove_if(std::begin(entitiesInGroup), std::end(entitiesInGroup), [i](GameEntity* mEntity) {
-			return !mEntity->IsAlive() || !mEntity->HasGroup(i);
-		}),
-			std::end(entitiesInGroup));
-	}
+		//Leave its groups, the group bitset is always
+		//in sync since 'DeleteGroup' removes right away.
+		for (auto i(0u); i < MaxGroups; ++i)
+		{
+			if (e->groupBitset[i])
+				groupedEntities[i].Erase(handle);
+		}
+
+		//Swap the last entity into the hole.
+		const std::uint32_t position(entityPositions[handle.Index()]);
+		GameEntity* last(entities.back());
+		entities[position] = last;
+		entityPositions[last->handle.Index()] = position;
+		entities.pop_back();
 
-	//Remove dead entities.
-	entities.erase(
-		std::remove_if(std::begin(entities), std::end(entities), [](const std::unique_ptr<GameEntity>& mEntity) {
-			return !mEntity->IsAlive();
-		}),
-		std::end(entities));
+		//Free it, the slot gets a new generation so every
+		//handle still pointing at it goes stale.
+		e->Clear();
+		e->handle = handle.NextGeneration();
+		slotHandles[handle.Index()] = e->handle;
+		freeSlots.emplace_back(handle.Index());
+	}
+	dirtyEntities.clear();
 }
 
 GameEntity& EntityManager::AddEntity()
 {
-	GameEntity* e(new GameEntity(*this));
-	std::unique_ptr<GameEntity> uPtr { e };
-	entities.emplace_back(std::move(uPtr));
+	return SpawnEntity(nullptr);
+}
+
+GameEntity& EntityManager::AddEntity(const ComponentBitset& signature)
+{
+	return SpawnEntity(&GetArchetype(signature));
+}
+
+GameEntity& EntityManager::SpawnEntity(Archetype* archetype)
+{
+	GameEntity* e { nullptr };
+	if (!freeSlots.empty())
+	{
+		//Recycle a dead entity instead of allocating a new one.
+		e = slots[freeSlots.back()].get();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		assert(slots.size() < EntityHandle::MaxEntities);
+		const auto index(static_cast<std::uint32_t>(slots.size()));
+		GameEntity* created(new (entityPool.Allocate()) GameEntity(*this, EntityHandle(index, 0)));
+		slots.emplace_back(created, PoolDeleter { &entityPool });
+		slotHandles.emplace_back(EntityHandle(index, 0));
+		entityPositions.emplace_back(0);
+		e = slots.back().get();
+	}
+
+	e->Spawn(archetype);
+	entityPositions[e->handle.Index()] = static_cast<std::uint32_t>(entities.size());
+	entities.emplace_back(e);
 	return *e;
 }
 
+Archetype& EntityManager::GetArchetype(const ComponentBitset& signature)
+{
+	auto found(archetypeLookup.find(signature));
+	if (found != archetypeLookup.end())
+		return *found->second;
+
+	archetypes.emplace_back(std::make_unique<Archetype>(signature, upstream, componentStats));
+	Archetype* archetype(archetypes.back().get());
+	archetypeLookup.emplace(signature, archetype);
+	return *archetype;
+}
+
 void EntityManager::AddToGroup(GameEntity* entity, Group group)
 {
-	groupedEntities[group].emplace_back(entity);
+	groupedEntities[group].Insert(entity->GetHandle());
+}
+
+void EntityManager::RemoveFromGroup(GameEntity* entity, Group group) noexcept
+{
+	groupedEntities[group].Erase(entity->GetHandle());
+}
+
+const std::vector<EntityHandle>& EntityManager::GetEntitiesByGroup(Group group) const noexcept
+{
+	return groupedEntities[group].Dense();
+}
+
+void EntityManager::DestroyEntity(GameEntity& entity)
+{
+	if (!entity.alive)
+		return;
+
+	entity.alive = false;
+	dirtyEntities.emplace_back(&entity);
+}
+
+PoolAllocator& EntityManager::GetComponentPool(ComponentID id, std::size_t size, std::size_t alignment)
+{
+	auto& pool(componentPools[id]);
+	if (pool == nullptr)
+		pool = std::make_unique<PoolAllocator>(size, alignment, ComponentColumn::ChunkRows, upstream, componentStats[id]);
+	return *pool;
+}
+
+void EntityManager::SaveSnapshot(SnapshotWriter& writer) const
+{
+	std::uint32_t count { 0 };
+	for (auto& e : entities)
+	{
+		if (e->alive)
+			++count;
+	}
+
+	writer.Write(SnapshotMagic);
+	writer.Write(SnapshotVersion);
+	writer.Write(count);
+
+	//Table first so every entity exists, and every saved
+	//handle can be mapped, before any component loads.
+	for (auto& e : entities)
+	{
+		if (!e->alive)
+			continue;
+
+		writer.WriteHandle(e->handle);
+		writer.Write(static_cast<std::uint8_t>(e->archetype != nullptr));
+		writer.Write(static_cast<std::uint64_t>(e->archetype != nullptr ? e->archetype->GetSignature().to_ullong() : 0));
+		writer.Write(static_cast<std::uint64_t>(e->groupBitset.to_ullong()));
+
+		writer.Write(static_cast<std::uint8_t>(e->components.size()));
+		for (auto& c : e->components)
+		{
+			ComponentID id { 0 };
+			while (e->componentArray[id] != c)
+				++id;
+			writer.Write(static_cast<std::uint8_t>(id));
+		}
+	}
+
+	for (auto& e : entities)
+	{
+		if (!e->alive)
+			continue;
+
+		for (auto& c : e->components)
+		{
+			const std::size_t block(writer.BeginBlock());
+			c->Save(writer);
+			writer.EndBlock(block);
+		}
+	}
+}
+
+bool EntityManager::LoadSnapshot(SnapshotReader& reader, const ComponentLoader& loader)
+{
+	if (reader.Read<std::uint32_t>() != SnapshotMagic || reader.Read<std::uint32_t>() != SnapshotVersion)
+	{
+		std::cout << "Error! Snapshot format not supported!" << std::endl;
+		return false;
+	}
+
+	//Check everything before the world is gone.
+	const std::size_t body(reader.GetOffset());
+	if (!CheckSnapshotBody(reader))
+		return false;
+	reader.Seek(body);
+
+	//Start from an empty world, slots are kept for reuse.
+	const auto clearWorld = [this]() {
+		commands.Clear();
+		for (auto& e : entities)
+			DestroyEntity(*e);
+		Refresh();
+	};
+	clearWorld();
+
+	struct PendingLoad
+	{
+		Component* Loaded;
+		std::size_t Begin;
+		std::size_t End;
+	};
+
+	const auto count(reader.Read<std::uint32_t>());
+	std::vector<GameEntity*> restored;
+	std::vector<std::uint8_t> ids;
+	std::vector<std::uint8_t> idCounts;
+	restored.reserve(count);
+
+	for (std::uint32_t i = 0; i < count && reader.IsValid(); ++i)
+	{
+		EntityHandle saved;
+		saved.Value = reader.Read<std::uint32_t>();
+		const bool packed(reader.Read<std::uint8_t>() != 0);
+		const ComponentBitset signature(reader.Read<std::uint64_t>());
+		const GroupBitset groups(reader.Read<std::uint64_t>());
+
+		GameEntity& e(packed ? AddEntity(signature) : AddEntity());
+		reader.MapHandle(saved, e.handle);
+		for (auto g(0u); g < MaxGroups; ++g)
+		{
+			if (groups[g])
+				e.AddGroup(g);
+		}
+
+		idCounts.emplace_back(reader.Read<std::uint8_t>());
+		for (std::uint8_t c = 0; c < idCounts.back(); ++c)
+			ids.emplace_back(reader.Read<std::uint8_t>());
+		restored.emplace_back(&e);
+	}
+
+	//Add components in their original order so 'Init()'
+	//finds what it needs, then load every state at once
+	//so no 'Init()' can overwrite a loaded one.
+	std::vector<PendingLoad> pending;
+	pending.reserve(ids.size());
+	std::size_t next { 0 };
+	for (std::size_t i = 0; i < restored.size() && reader.IsValid(); ++i)
+	{
+		for (std::uint8_t c = 0; c < idCounts[i]; ++c)
+		{
+			const ComponentID id(ids[next++]);
+			const auto size(reader.Read<std::uint32_t>());
+			const std::size_t end(reader.GetOffset() + size);
+			if (id >= MaxComponents || !reader.IsValid())
+			{
+				clearWorld();
+				return false;
+			}
+
+			Component* loaded(loader(*restored[i], id, reader));
+			pending.emplace_back(PendingLoad { loaded, reader.GetOffset(), end });
+			reader.Seek(end);
+		}
+	}
+
+	for (auto& p : pending)
+	{
+		if (p.Loaded == nullptr)
+			continue;
+
+		reader.Seek(p.Begin);
+		p.Loaded->Load(reader);
+		reader.Seek(p.End);
+	}
+
+	//A component read past the end, no half loaded world.
+	if (!reader.IsValid())
+	{
+		clearWorld();
+		return false;
+	}
+	return true;
+}
+
+void EntityManager::OnLooseComponentsAdded(std::size_t count) noexcept
+{
+	looseComponentCount += count;
 }
 
-std::vector<GameEntity*>& EntityManager::GetEntitiesByGroup(Group group)
+void EntityManager::OnLooseComponentsRemoved(std::size_t count) noexcept
 {
-	return groupedEntities[group];
+	looseComponentCount -= count;
 }
 
 }
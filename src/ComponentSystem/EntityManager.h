@@ -1,30 +1,230 @@
 #pragma once
+#include "Archetype.h"
+#include "CommandBuffer.h"
 #include "ComponentSystemDefine.h"
 #include "GameEntity.h"
+#include "PoolAllocator.h"
+#include "Snapshot.h"
+#include "SparseSet.h"
+#include <memory_resource>
+#include <unordered_map>
 
 /////////////////////////////////////////////////
 ///This file is for EntityManager that handles
 ///all GameEntity and their states.
+///
+///Entities are never deleted. A dead entity is
+///cleared and its slot goes to a free list, so the
+///next AddEntity reuses it with a new generation.
+///
+///Refresh() first applies the CommandBuffer, then
+///only looks at entities destroyed since the last
+///call, not at every entity and group.
+///
+///SaveSnapshot()/LoadSnapshot() capture and restore
+///every alive entity, see Snapshot.h.
 /////////////////////////////////////////////////
 namespace ComponentSystem
 {
 class GameEntity;
+class System;
+class ThreadPool;
+template <typename... Ts>
+class ComponentView;
 
 class EntityManager
 {
+public:
+	//Adds the component 'id' to the entity, reading what its
+	//constructor needs from the reader, and returns it.
+	//nullptr skips the component.
+	using ComponentLoader = std::function<Component*(GameEntity&, ComponentID, SnapshotReader&)>;
+
 private:
-	std::vector<std::unique_ptr<GameEntity>> entities;
-	std::array<std::vector<GameEntity*>, MaxGroups> groupedEntities;
+	//Where slabs and archetype chunks come from.
+	std::pmr::memory_resource* upstream;
+
+	//Live/peak/slab bytes of every component type, whether it
+	//is stored in an archetype column or in a pool.
+	std::array<PoolStats, MaxComponents> componentStats;
+	PoolStats entityStats;
+
+	//Pools and Archetypes must outlive the entities using them,
+	//so keep them declared first and destroyed last.
+	std::array<std::unique_ptr<PoolAllocator>, MaxComponents> componentPools;
+	PoolAllocator entityPool;
+	std::vector<std::unique_ptr<Archetype>> archetypes;
+	std::unordered_map<ComponentBitset, Archetype*> archetypeLookup;
+
+	//Number of components living outside any Archetype.
+	std::size_t looseComponentCount { 0 };
+
+	//Every slot ever used, indexed by 'EntityHandle::Index()'.
+	//The current handle of each slot is kept on its own so a
+	//validity check only touches this small array.
+	std::vector<PoolPtr<GameEntity>> slots;
+	std::vector<EntityHandle> slotHandles;
+	std::vector<std::uint32_t> freeSlots;
+
+	//Entities in use. Freed ones are swapped with the last,
+	//'entityPositions' maps a slot index to its place here.
+	std::vector<GameEntity*> entities;
+	std::vector<std::uint32_t> entityPositions;
+	std::array<SparseSet, MaxGroups> groupedEntities;
+
+	//Entities destroyed since the last Refresh().
+	std::vector<GameEntity*> dirtyEntities;
+
+	//Structural changes waiting for the next Refresh().
+	CommandBuffer commands;
+
+	//Update pipeline, in running order, and the components
+	//its enabled Systems take away from the legacy path.
+	std::vector<std::unique_ptr<System>> systems;
+	std::vector<std::vector<System*>> systemStages;
+	ComponentBitset systemComponents;
+
+	//Not owned, nullptr runs everything on the calling thread.
+	ThreadPool* threadPool { nullptr };
+
+	void PushSystem(std::unique_ptr<System> system);
+	Archetype& GetArchetype(const ComponentBitset& signature);
+	GameEntity& SpawnEntity(Archetype* archetype);
 
 public:
+	explicit EntityManager(std::pmr::memory_resource* mUpstream = std::pmr::get_default_resource());
+	~EntityManager();
+
+	EntityManager(const EntityManager&) = delete;
+	EntityManager& operator=(const EntityManager&) = delete;
+
+	//Runs the Systems, or every component's 'Update'
+	//when no System was added.
 	void Update(float mFT);
-	void Render();
+	//Virtual 'Update' of every component no enabled
+	//System owns, see LegacyUpdateSystem.
+	void UpdateComponents(float mFT);
+	//Components in 'skip' are drawn by someone else.
+	void Render(const ComponentBitset& skip = ComponentBitset {});
 	void Refresh();
 
+	//Components are allocated one by one.
 	GameEntity& AddEntity();
+	//Components in 'signature' are packed with other entities
+	//having the same signature, see Archetype.
+	GameEntity& AddEntity(const ComponentBitset& signature);
+
+	//A handle is valid until its entity is freed by Refresh().
+	bool IsValid(EntityHandle handle) const noexcept;
+	GameEntity& GetEntity(EntityHandle handle) const;
+	GameEntity* TryGetEntity(EntityHandle handle) const noexcept;
+
+	//Append a System to the pipeline, 'T' must derive from System.
+	template <typename T, typename... TArgs>
+	T& AddSystem(TArgs&&... mArgs)
+	{
+		auto system(std::make_unique<T>(std::forward<TArgs>(mArgs)...));
+		T& added(*system);
+		PushSystem(std::move(system));
+		return added;
+	}
+
+	const std::vector<std::unique_ptr<System>>& GetSystems() const noexcept
+	{
+		return systems;
+	}
+
+	//Stages the Systems ran in during the last Update.
+	const std::vector<std::vector<System*>>& GetSystemStages() const noexcept
+	{
+		return systemStages;
+	}
+
+	void SetThreadPool(ThreadPool* pool) noexcept
+	{
+		threadPool = pool;
+	}
+
+	ThreadPool* GetThreadPool() const noexcept
+	{
+		return threadPool;
+	}
+
+	//Entities having all of 'Ts', see View.h.
+	template <typename... Ts>
+	ComponentView<Ts...> View();
+
+	const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const noexcept
+	{
+		return archetypes;
+	}
+
+	const std::vector<GameEntity*>& GetEntities() const noexcept
+	{
+		return entities;
+	}
+
+	bool HasLooseComponents() const noexcept
+	{
+		return looseComponentCount > 0;
+	}
 
 	void AddToGroup(GameEntity* entity, Group group);
-	std::vector<GameEntity*>& GetEntitiesByGroup(Group group);
+	void RemoveFromGroup(GameEntity* entity, Group group) noexcept;
+	//Removing from a group swaps handles around, so do not
+	//call 'DeleteGroup' while iterating the same group.
+	const std::vector<EntityHandle>& GetEntitiesByGroup(Group group) const noexcept;
+
+	//Record changes here while iterating entities or groups.
+	CommandBuffer& GetCommandBuffer() noexcept
+	{
+		return commands;
+	}
+
+	//Kill the entity right away, it is freed in the next Refresh().
+	//Do not call while iterating, use 'GameEntity::Destroy()'.
+	void DestroyEntity(GameEntity& entity);
+
+	//Pool for components that are not stored in an Archetype.
+	PoolAllocator& GetComponentPool(ComponentID id, std::size_t size, std::size_t alignment);
+
+	const PoolStats& GetComponentStats(ComponentID id) const noexcept
+	{
+		return componentStats[id];
+	}
+
+	const PoolStats& GetEntityStats() const noexcept
+	{
+		return entityStats;
+	}
+
+	//Only alive entities are saved, pending commands are not.
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	//Replace every entity with the ones in the snapshot. Call
+	//it where 'Refresh()' could be called, not while iterating.
+	//Handles change, saved ones are mapped in the reader.
+	//A broken table leaves the world as it was, a component
+	//failing to load leaves it empty, both return false.
+	bool LoadSnapshot(SnapshotReader& reader, const ComponentLoader& loader);
+
+	void OnLooseComponentsAdded(std::size_t count) noexcept;
+	void OnLooseComponentsRemoved(std::size_t count) noexcept;
 };
 
+inline bool EntityManager::IsValid(EntityHandle handle) const noexcept
+{
+	return handle.Index() < slotHandles.size() && slotHandles[handle.Index()] == handle;
+}
+
+inline GameEntity& EntityManager::GetEntity(EntityHandle handle) const
+{
+	assert(IsValid(handle));
+	return *slots[handle.Index()];
+}
+
+inline GameEntity* EntityManager::TryGetEntity(EntityHandle handle) const noexcept
+{
+	return IsValid(handle) ? slots[handle.Index()].get() : nullptr;
+}
+
 }
@@ -3,6 +3,40 @@
 namespace ComponentSystem
 {
 
+GameEntity::~GameEntity()
+{
+	Clear();
+}
+
+void GameEntity::Spawn(Archetype* mArchetype)
+{
+	alive = true;
+	archetype = mArchetype;
+	if (archetype != nullptr)
+		archetypeRow = archetype->AllocateRow(this);
+}
+
+void GameEntity::Clear() noexcept
+{
+	//Components in the Archetype columns are not owned
+	//by us, give the row back so they get destroyed.
+	if (archetype != nullptr)
+		archetype->FreeRow(archetypeRow);
+	archetype = nullptr;
+
+	if (!looseComponents.empty())
+		manager.OnLooseComponentsRemoved(looseComponents.size());
+
+	//'clear()' keeps the capacity around for the next life.
+	looseComponents.clear();
+	looseIDs.clear();
+	components.clear();
+	componentArray.fill(nullptr);
+	componentBitset.reset();
+	groupBitset.reset();
+	alive = false;
+}
+
 bool GameEntity::IsAlive() const
 {
 	return alive;
@@ -10,21 +44,31 @@ bool GameEntity::IsAlive() const
 
 void GameEntity::Destroy()
 {
-	alive = false;
+	manager.GetCommandBuffer().Destroy(handle);
 }
 
-void GameEntity::Update(float mFT)
+void GameEntity::Update(float mFT, const ComponentBitset& skip)
 {
-	for (auto& c : components)
+	for (std::size_t i = 0; i < looseComponents.size(); ++i)
 	{
-		c->Update(mFT);
+		if (!skip[looseIDs[i]])
+			looseComponents[i]->Update(mFT);
 	}
 }
 
-void GameEntity::Render()
+void GameEntity::Render(const ComponentBitset& skip)
 {
+	const ComponentBitset skipped(componentBitset & skip);
 	for (auto& c : components)
 	{
+		if (skipped.any())
+		{
+			ComponentID id { 0 };
+			while (componentArray[id] != c)
+				++id;
+			if (skipped[id])
+				continue;
+		}
 		c->Render();
 	}
 }
@@ -36,13 +80,32 @@ bool GameEntity::HasGroup(Group group) const noexcept
 
 void GameEntity::AddGroup(Group group) noexcept
 {
+	if (groupBitset[group])
+		return;
+
 	groupBitset[group] = true;
 	manager.AddToGroup(this, group);
 }
 
 void GameEntity::DeleteGroup(Group group) noexcept
 {
+	if (!groupBitset[group])
+		return;
+
 	groupBitset[group] = false;
+	manager.RemoveFromGroup(this, group);
+}
+
+PoolAllocator& GameEntity::GetLoosePool(ComponentID id, std::size_t size, std::size_t alignment)
+{
+	return manager.GetComponentPool(id, size, alignment);
+}
+
+void GameEntity::AddLooseComponent(ComponentID id, PoolPtr<Component> component)
+{
+	looseComponents.emplace_back(std::move(component));
+	looseIDs.emplace_back(id);
+	manager.OnLooseComponentsAdded(1);
 }
 
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include "Archetype.h"
+#include "ComponentRegistry.h"
 #include "ComponentSystemDefine.h"
 #include "EntityManager.h"
 #include <cassert>
@@ -12,26 +14,14 @@
 /////////////////////////////////////////////////
 namespace ComponentSystem
 {
-//hide this implementation detail.
-namespace Internal
+//Build the ComponentBitset of a set of components,
+//mostly used to pick an Archetype for a new entity.
+template <typename... Ts>
+inline ComponentBitset GetComponentBitset() noexcept
 {
-inline ComponentID GetUniqueComponentID() noexcept
-{
-	static ComponentID lastID { 0u };
-	return lastID++;
-}
-}
-
-//Everytime we instantiate 'GetComponentTypeID()',
-//the static 'lastID' will ++ , making the ID unique.
-template <typename T>
-inline ComponentID GetComponentTypeID() noexcept
-{
-	static_assert(std::is_base_of<Component, T>::value,
-		"T must inherit from Component");
-
-	static ComponentID typeID { Internal::GetUniqueComponentID() };
-	return typeID;
+	ComponentBitset bitset;
+	(bitset.set(GetComponentTypeID<Ts>()), ...);
+	return bitset;
 }
 
 /*
@@ -53,34 +43,96 @@ struct Component
 	{}
 	virtual void Render()
 	{}
+
+	//State to keep in a snapshot. Pointers to other
+	//components are set again by 'Init()', handles
+	//must go through 'WriteHandle'/'ReadHandle'.
+	virtual void Save(SnapshotWriter&) const
+	{}
+	virtual void Load(SnapshotReader&)
+	{}
 };
 
 /*
  * GameEntity is the most basic element in the system.
  * It is a container of Component.
+ *
+ * Components listed in the entity's Archetype live in
+ * the Archetype's columns, anything else is allocated
+ * on its own and owned by the entity.
  */
 class GameEntity
 {
+	//The manager recycles entities in place.
+	friend class EntityManager;
+
 private:
 	EntityManager& manager;
+	EntityHandle handle;
+	Archetype* archetype { nullptr };
+	std::size_t archetypeRow { 0 };
 
 	bool alive { true };
-	std::vector<std::unique_ptr<Component>> components;
+	std::vector<Component*> components;
+	std::vector<PoolPtr<Component>> looseComponents;
+	std::vector<ComponentID> looseIDs;
 	ComponentArray componentArray;
 	ComponentBitset componentBitset;
 
 	GroupBitset groupBitset;
 
+	PoolAllocator& GetLoosePool(ComponentID id, std::size_t size, std::size_t alignment);
+	void AddLooseComponent(ComponentID id, PoolPtr<Component> component);
+
+	//Bring a free slot back to life, optionally in an Archetype.
+	void Spawn(Archetype* mArchetype);
+	//Drop all components and groups so the slot can be reused.
+	void Clear() noexcept;
+
 public:
-	GameEntity(EntityManager& mManager) :
-		manager(mManager)
+	GameEntity(EntityManager& mManager, EntityHandle mHandle) :
+		manager(mManager),
+		handle(mHandle)
 	{}
+	~GameEntity();
+
+	GameEntity(const GameEntity&) = delete;
+	GameEntity& operator=(const GameEntity&) = delete;
+
+	EntityHandle GetHandle() const noexcept
+	{
+		return handle;
+	}
+
+	EntityManager& GetManager() const noexcept
+	{
+		return manager;
+	}
+
+	//nullptr when every component is stored on its own.
+	Archetype* GetArchetype() const noexcept
+	{
+		return archetype;
+	}
+
+	//Components the entity has right now.
+	const ComponentBitset& GetSignature() const noexcept
+	{
+		return componentBitset;
+	}
 
 	bool IsAlive() const;
+	//Recorded in the CommandBuffer, the entity dies in the
+	//next Refresh() and is freed right after.
 	void Destroy();
 
-	void Update(float mFT);
-	void Render();
+	//Archetype columns are updated by the EntityManager,
+	//so this only updates components stored out of them.
+	//Components in 'skip' are left to their System.
+	void Update(float mFT, const ComponentBitset& skip);
+	//In adding order, components in 'skip' are drawn by
+	//someone else, e.g. a batch.
+	void Render(const ComponentBitset& skip);
 
 	bool HasGroup(Group group) const noexcept;
 	void AddGroup(Group group) noexcept;
@@ -123,19 +175,41 @@ T& GameEntity::AddComponent(TArgs&&... mArgs)
 	//If so, can't add because only one is allowed, error.
 	assert(!HasComponent<T>());
 
-	//Allocate component of type 'T' on the HEAP
-	//and forward the arguments to its constructor
-	T* c(new T(std::forward<TArgs>(mArgs)...));
+	T* c { nullptr };
+	if (archetype != nullptr && archetype->Stores(GetComponentTypeID<T>()))
+	{
+		//Construct the component in place, right next to
+		//the same component of the other entities.
+		c = archetype->Emplace<T>(GetComponentTypeID<T>(), archetypeRow, std::forward<TArgs>(mArgs)...);
+	}
+	else
+	{
+		//Not part of the Archetype, so take a block from the
+		//pool of 'T' and forward the arguments to its constructor
+		PoolAllocator& pool(GetLoosePool(GetComponentTypeID<T>(), sizeof(T), alignof(T)));
+		void* block(pool.Allocate());
+		try
+		{
+			c = new (block) T(std::forward<TArgs>(mArgs)...);
+		}
+		catch (...)
+		{
+			pool.Deallocate(block);
+			throw;
+		}
+
+		//Wrap raw pointer to smart pointer, the deleter gives
+		//the block back to the pool.
+		//Aso, smart pointer is not copyable so we must move it
+		PoolPtr<Component> uPtr { c, PoolDeleter { &pool } };
+		AddLooseComponent(GetComponentTypeID<T>(), std::move(uPtr));
+	}
 
 	//Set the parent of the component to this instance
 	c->Entity = this;
 
-	//Wrap raw pointer to smart pointer
-	std::unique_ptr<Component> uPtr { c };
-
-	//Add the smart pointer to the 'components' container
-	//Aso, smart pointer is not copyable so we must move it
-	components.emplace_back(std::move(uPtr));
+	//Keep the adding order for rendering.
+	components.emplace_back(c);
 
 	//Instantiate an id and add the pointer to array.
 	componentArray[GetComponentTypeID<T>()] = c;
@@ -0,0 +1,75 @@
+#include "PoolAllocator.h"
+#include <algorithm>
+
+namespace ComponentSystem
+{
+
+PoolAllocator::PoolAllocator(std::size_t mSize, std::size_t mAlignment, std::size_t mBlocksPerSlab,
+	std::pmr::memory_resource* mUpstream, PoolStats& mStats) :
+	alignment(std::max(mAlignment, alignof(FreeBlock))),
+	blocksPerSlab(mBlocksPerSlab),
+	upstream(mUpstream),
+	stats(mStats)
+{
+	//A free block stores the next pointer in itself,
+	//and every block must stay aligned.
+	blockSize = std::max(mSize, sizeof(FreeBlock));
+	blockSize = (blockSize + alignment - 1) / alignment * alignment;
+}
+
+PoolAllocator::~PoolAllocator()
+{
+	for (auto& slab : slabs)
+		upstream->deallocate(slab, blockSize * blocksPerSlab, alignment);
+	stats.SlabBytes -= slabs.size() * blockSize * blocksPerSlab;
+}
+
+void PoolAllocator::AddSlab()
+{
+	const std::size_t bytes(blockSize * blocksPerSlab);
+	auto* slab(static_cast<unsigned char*>(upstream->allocate(bytes, alignment)));
+	slabs.emplace_back(slab);
+	stats.SlabBytes += bytes;
+
+	//Push backwards so blocks are handed out in address order.
+	for (std::size_t i = blocksPerSlab; i > 0; --i)
+	{
+		auto* block(reinterpret_cast<FreeBlock*>(slab + (i - 1) * blockSize));
+		block->next = freeList;
+		freeList = block;
+	}
+}
+
+void* PoolAllocator::Allocate()
+{
+	if (freeList == nullptr)
+		AddSlab();
+
+	FreeBlock* block(freeList);
+	freeList = block->next;
+	++liveBlocks;
+	stats.OnAllocate();
+	return block;
+}
+
+void PoolAllocator::Deallocate(void* block) noexcept
+{
+	if (block == nullptr)
+		return;
+
+	auto* freed(static_cast<FreeBlock*>(block));
+	freed->next = freeList;
+	freeList = freed;
+	--liveBlocks;
+	stats.OnDeallocate();
+}
+
+void PoolAllocator::Reserve(std::size_t count)
+{
+	const std::size_t capacity(slabs.size() * blocksPerSlab);
+	const std::size_t wanted(liveBlocks + count);
+	for (std::size_t c = capacity; c < wanted; c += blocksPerSlab)
+		AddSlab();
+}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+/////////////////////////////////////////////////
+///This file defines PoolAllocator, a fixed-size
+///block allocator used for entities and components.
+///
+///Memory comes from an upstream std::pmr resource
+///in slabs of many blocks. Freed blocks go to a
+///free list and are handed out again before any
+///new slab is requested, so spawning and killing
+///a wave does not hit malloc/free for every object.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+//Counters of one pool, or of one component type.
+struct PoolStats
+{
+	std::size_t Live { 0 };
+	std::size_t Peak { 0 };
+	std::size_t SlabBytes { 0 };
+
+	void OnAllocate() noexcept
+	{
+		++Live;
+		if (Live > Peak)
+			Peak = Live;
+	}
+
+	void OnDeallocate() noexcept
+	{
+		--Live;
+	}
+};
+
+class PoolAllocator
+{
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	std::size_t blockSize;
+	std::size_t alignment;
+	std::size_t blocksPerSlab;
+	std::pmr::memory_resource* upstream;
+	PoolStats& stats;
+
+	FreeBlock* freeList { nullptr };
+	std::vector<void*> slabs;
+	std::size_t liveBlocks { 0 };
+
+	void AddSlab();
+
+public:
+	PoolAllocator(std::size_t mSize, std::size_t mAlignment, std::size_t mBlocksPerSlab,
+		std::pmr::memory_resource* mUpstream, PoolStats& mStats);
+	~PoolAllocator();
+
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+	void* Allocate();
+	void Deallocate(void* block) noexcept;
+
+	//Make sure 'count' blocks can be handed out without a new slab.
+	void Reserve(std::size_t count);
+
+	std::size_t GetLiveBlocks() const noexcept
+	{
+		return liveBlocks;
+	}
+};
+
+//Destroys an object and gives its block back to the pool.
+struct PoolDeleter
+{
+	PoolAllocator* pool { nullptr };
+
+	template <typename T>
+	void operator()(T* mObject) const noexcept
+	{
+		//A base pointer may not point at the start of
+		//the block, ask for the most derived object.
+		void* block { nullptr };
+		if constexpr (std::is_polymorphic<T>::value)
+			block = dynamic_cast<void*>(mObject);
+		else
+			block = mObject;
+
+		mObject->~T();
+		pool->Deallocate(block);
+	}
+};
+
+template <typename T>
+using PoolPtr = std::unique_ptr<T, PoolDeleter>;
+
+}
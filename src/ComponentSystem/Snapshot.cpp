@@ -0,0 +1,109 @@
+#include "Snapshot.h"
+#include <fstream>
+
+namespace ComponentSystem
+{
+
+void SnapshotWriter::WriteString(const std::string& mValue)
+{
+	Write(static_cast<std::uint32_t>(mValue.size()));
+	buffer.insert(buffer.end(), mValue.begin(), mValue.end());
+}
+
+void SnapshotWriter::WriteHandle(EntityHandle mHandle)
+{
+	Write(mHandle.Value);
+}
+
+std::size_t SnapshotWriter::BeginBlock()
+{
+	const std::size_t block(buffer.size());
+	Write(std::uint32_t { 0 });
+	return block;
+}
+
+void SnapshotWriter::EndBlock(std::size_t block)
+{
+	const auto blockSize(static_cast<std::uint32_t>(buffer.size() - block - sizeof(std::uint32_t)));
+	std::memcpy(buffer.data() + block, &blockSize, sizeof(blockSize));
+}
+
+bool SnapshotWriter::SaveToFile(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cout << "Error! Can not write snapshot " << path << std::endl;
+		return false;
+	}
+
+	file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	return static_cast<bool>(file);
+}
+
+bool SnapshotReader::Take(void* mOut, std::size_t count) noexcept
+{
+	if (failed || size - offset < count)
+	{
+		failed = true;
+		std::memset(mOut, 0, count);
+		return false;
+	}
+
+	std::memcpy(mOut, data + offset, count);
+	offset += count;
+	return true;
+}
+
+std::string SnapshotReader::ReadString()
+{
+	const auto length(Read<std::uint32_t>());
+	if (failed || size - offset < length)
+	{
+		failed = true;
+		return std::string();
+	}
+
+	std::string value(data + offset, length);
+	offset += length;
+	return value;
+}
+
+EntityHandle SnapshotReader::ReadHandle()
+{
+	const auto saved(Read<std::uint32_t>());
+	auto found(handles.find(saved));
+	return found != handles.end() ? found->second : NullEntity;
+}
+
+void SnapshotReader::MapHandle(EntityHandle saved, EntityHandle restored)
+{
+	handles[saved.Value] = restored;
+}
+
+void SnapshotReader::Seek(std::size_t mOffset) noexcept
+{
+	if (mOffset > size)
+	{
+		failed = true;
+		return;
+	}
+	offset = mOffset;
+}
+
+bool SnapshotReader::LoadFile(const std::string& path, std::vector<char>& buffer)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		std::cout << "Error! Snapshot " << path << " not found!" << std::endl;
+		return false;
+	}
+
+	buffer.resize(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	return static_cast<bool>(file);
+}
+
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "ComponentSystemDefine.h"
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/////////////////////////////////////////////////
+///This file defines the binary snapshot format of
+///the EntityManager.
+///
+///SnapshotWriter appends plain bytes to a buffer,
+///SnapshotReader reads them back from any memory,
+///a file loaded in a vector or a mapped file alike.
+///Values are stored as they are in memory, so a
+///snapshot only loads on the same kind of machine.
+///
+///Layout (version 3):
+///  header  magic, version, entity count
+///  table   per entity: handle, packed flag, archetype
+///          signature, groups, component IDs in adding
+///          order
+///  blocks  per component: byte size, then whatever
+///          'Component::Save' wrote
+///
+///Version 2 added 'Continuous' and the last step
+///position to the CPhysics block. Version 3 keeps
+///only the emitter settings in the CParticle block,
+///particles in the air are not saved anymore.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+constexpr std::uint32_t SnapshotMagic { 0x504E5350 }; //"PSNP"
+constexpr std::uint32_t SnapshotVersion { 3 };
+
+class SnapshotWriter
+{
+private:
+	std::vector<char> buffer;
+
+public:
+	template <typename T>
+	void Write(const T& mValue)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written as bytes");
+
+		const char* bytes(reinterpret_cast<const char*>(&mValue));
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	void WriteString(const std::string& mValue);
+	void WriteHandle(EntityHandle mHandle);
+
+	//Random engines only expose their state as text.
+	template <typename TEngine>
+	void WriteRandom(const TEngine& mEngine)
+	{
+		std::ostringstream state;
+		state << mEngine;
+		WriteString(state.str());
+	}
+
+	//Size placeholder, give the result to 'EndBlock'.
+	std::size_t BeginBlock();
+	void EndBlock(std::size_t block);
+
+	const std::vector<char>& GetBuffer() const noexcept
+	{
+		return buffer;
+	}
+
+	void Clear() noexcept
+	{
+		buffer.clear();
+	}
+
+	bool SaveToFile(const std::string& path) const;
+};
+
+class SnapshotReader
+{
+private:
+	const char* data;
+	std::size_t size;
+	std::size_t offset { 0 };
+	bool failed { false };
+
+	//Handles in the snapshot to the entities restored from them.
+	std::unordered_map<std::uint32_t, EntityHandle> handles;
+
+	bool Take(void* mOut, std::size_t count) noexcept;
+
+public:
+	//The memory must outlive the reader.
+	SnapshotReader(const void* mData, std::size_t mSize) :
+		data(static_cast<const char*>(mData)),
+		size(mSize)
+	{}
+	explicit SnapshotReader(const std::vector<char>& mBuffer) :
+		SnapshotReader(mBuffer.data(), mBuffer.size())
+	{}
+
+	//A read past the end zero-fills and marks the reader as failed.
+	template <typename T>
+	T Read()
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read as bytes");
+
+		T value {};
+		Take(&value, sizeof(T));
+		return value;
+	}
+
+	template <typename T>
+	void Read(T& mValue)
+	{
+		mValue = Read<T>();
+	}
+
+	std::string ReadString();
+	//Gives the entity now restored from the saved handle,
+	//or NullEntity if it was not in the snapshot.
+	EntityHandle ReadHandle();
+
+	template <typename TEngine>
+	void ReadRandom(TEngine& mEngine)
+	{
+		std::istringstream state(ReadString());
+		state >> mEngine;
+	}
+
+	void MapHandle(EntityHandle saved, EntityHandle restored);
+
+	std::size_t GetOffset() const noexcept
+	{
+		return offset;
+	}
+
+	//Jump to 'mOffset', used to skip the rest of a block.
+	void Seek(std::size_t mOffset) noexcept;
+
+	bool IsValid() const noexcept
+	{
+		return !failed;
+	}
+
+	static bool LoadFile(const std::string& path, std::vector<char>& buffer);
+};
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "EntityHandle.h"
+#include <cstdint>
+#include <vector>
+
+/////////////////////////////////////////////////
+///This file defines SparseSet, a set of entity
+///handles with O(1) insert, erase and lookup.
+///
+///Handles are packed in 'dense' so the set can be
+///iterated like a plain vector. 'sparse' maps the
+///slot index of a handle to its place in 'dense'.
+///Erasing swaps the last handle into the hole, so
+///the order of 'dense' is not kept.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+class SparseSet
+{
+private:
+	static constexpr std::uint32_t npos { 0xFFFFFFFFu };
+
+	std::vector<EntityHandle> dense;
+	std::vector<std::uint32_t> sparse;
+
+public:
+	bool Contains(EntityHandle handle) const noexcept
+	{
+		const std::uint32_t index(handle.Index());
+		return index < sparse.size() && sparse[index] != npos && dense[sparse[index]] == handle;
+	}
+
+	void Insert(EntityHandle handle)
+	{
+		if (Contains(handle))
+			return;
+
+		const std::uint32_t index(handle.Index());
+		if (sparse.size() <= index)
+			sparse.resize(index + 1, npos);
+
+		sparse[index] = static_cast<std::uint32_t>(dense.size());
+		dense.emplace_back(handle);
+	}
+
+	void Erase(EntityHandle handle) noexcept
+	{
+		if (!Contains(handle))
+			return;
+
+		const std::uint32_t position(sparse[handle.Index()]);
+		const EntityHandle last(dense.back());
+		dense[position] = last;
+		sparse[last.Index()] = position;
+
+		dense.pop_back();
+		sparse[handle.Index()] = npos;
+	}
+
+	std::size_t Size() const noexcept
+	{
+		return dense.size();
+	}
+
+	const std::vector<EntityHandle>& Dense() const noexcept
+	{
+		return dense;
+	}
+};
+
+}
@@ -0,0 +1,79 @@
+#include "System.h"
+#include <chrono>
+
+namespace ComponentSystem
+{
+
+static void RunSystem(EntityManager& manager, System& system, float mFT)
+{
+	const auto start(std::chrono::steady_clock::now());
+	system.Update(manager, mFT);
+	const std::chrono::duration<float, std::milli> elapsed(std::chrono::steady_clock::now() - start);
+	system.LastUpdateMs = elapsed.count();
+}
+
+void BuildSystemStages(const std::vector<std::unique_ptr<System>>& systems, std::vector<SystemStage>& stages)
+{
+	for (auto& stage : stages)
+		stage.clear();
+
+	std::size_t count { 0 };
+	for (auto& s : systems)
+	{
+		if (!s->Enabled)
+			continue;
+
+		//Only ever look at the last stage so Systems that
+		//conflict keep the order they were added in.
+		bool fits(count > 0);
+		if (fits)
+		{
+			for (auto& other : stages[count - 1])
+			{
+				if (s->ConflictsWith(*other))
+				{
+					fits = false;
+					break;
+				}
+			}
+		}
+
+		if (!fits)
+		{
+			if (stages.size() <= count)
+				stages.emplace_back();
+			++count;
+		}
+		stages[count - 1].emplace_back(s.get());
+	}
+
+	stages.resize(count);
+}
+
+void RunSystemStage(EntityManager& manager, const SystemStage& stage, float mFT)
+{
+	ThreadPool* pool(manager.GetThreadPool());
+	if (pool == nullptr || stage.size() == 1)
+	{
+		//Exclusive Systems always end up here, alone on
+		//the calling thread.
+		for (auto& s : stage)
+			RunSystem(manager, *s, mFT);
+		return;
+	}
+
+	TaskCounter counter { 0 };
+	for (std::size_t i = 1; i < stage.size(); ++i)
+	{
+		System* system(stage[i]);
+		pool->Submit([&manager, system, mFT]() {
+			RunSystem(manager, *system, mFT);
+		},
+			counter);
+	}
+
+	RunSystem(manager, *stage[0], mFT);
+	pool->Wait(counter);
+}
+
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include "ComponentSystemDefine.h"
+#include "EntityManager.h"
+#include "GameEntity.h"
+#include "ThreadPool.h"
+
+/////////////////////////////////////////////////
+///This file defines System, a step of the update
+///pipeline run by the EntityManager.
+///
+///A System updates one component type for all
+///entities in one loop instead of letting every
+///entity call the virtual 'Update' of each of its
+///components. Components no enabled System owns
+///are still updated the old way by LegacyUpdateSystem,
+///so Systems can be added one at a time.
+///
+///Systems declare the components they read and
+///write. Systems next to each other in the pipeline
+///that do not conflict form a stage and run at the
+///same time on the EntityManager's ThreadPool.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+/*
+ * Base of every System. The EntityManager runs the
+ * enabled ones in the order they were added and
+ * records how long each of them took.
+ */
+class System
+{
+private:
+	std::string name;
+	ComponentBitset components;
+	ComponentBitset reads;
+	ComponentBitset writes;
+	bool exclusive { true };
+	bool parallel { false };
+
+protected:
+	//Components 'Update' touches, of any entity. A System
+	//that never declares them runs alone on the calling thread.
+	void DeclareAccess(const ComponentBitset& mReads, const ComponentBitset& mWrites) noexcept
+	{
+		reads = mReads;
+		writes = mWrites;
+		exclusive = false;
+	}
+
+	//Set when updating one component only writes to its own
+	//entity, so the components can be split among threads.
+	void SetParallel(bool mParallel) noexcept
+	{
+		parallel = mParallel;
+	}
+
+public:
+	bool Enabled { true };
+	float LastUpdateMs { 0.f };
+
+	System(std::string mName, const ComponentBitset& mComponents) :
+		name(std::move(mName)),
+		components(mComponents)
+	{}
+	virtual ~System()
+	{}
+
+	const std::string& GetName() const noexcept
+	{
+		return name;
+	}
+
+	//Components updated by this System, the legacy
+	//path skips them while the System is enabled.
+	const ComponentBitset& GetComponents() const noexcept
+	{
+		return components;
+	}
+
+	bool IsExclusive() const noexcept
+	{
+		return exclusive;
+	}
+
+	bool IsParallel() const noexcept
+	{
+		return parallel;
+	}
+
+	//Two Systems conflict when one writes what the other uses.
+	bool ConflictsWith(const System& other) const noexcept
+	{
+		if (exclusive || other.exclusive)
+			return true;
+
+		return (writes & (other.reads | other.writes)).any() || (other.writes & reads).any();
+	}
+
+	virtual void Update(EntityManager& manager, float mFT) = 0;
+};
+
+using SystemStage = std::vector<System*>;
+
+//Split the enabled Systems into stages, in order. A stage
+//ends as soon as the next System conflicts with one in it.
+void BuildSystemStages(const std::vector<std::unique_ptr<System>>& systems, std::vector<SystemStage>& stages);
+//Run every System of the stage, each on its own task when
+//there are more than one, and wait for all of them.
+void RunSystemStage(EntityManager& manager, const SystemStage& stage, float mFT);
+
+//Visit every 'T', column by column first, then the
+//ones stored out of any Archetype.
+template <typename T, typename F>
+void ForEachComponent(EntityManager& manager, F&& mFunc)
+{
+	const ComponentID id(GetComponentTypeID<T>());
+	for (auto& a : manager.GetArchetypes())
+	{
+		ComponentColumn* column(a->GetColumn(id));
+		if (column != nullptr)
+			column->ForEach<T>(mFunc);
+	}
+
+	if (!manager.HasLooseComponents())
+		return;
+
+	for (auto& e : manager.GetEntities())
+	{
+		if (!e->HasComponent<T>())
+			continue;
+
+		Archetype* archetype(e->GetArchetype());
+		if (archetype == nullptr || !archetype->Stores(id))
+			mFunc(e->GetComponent<T>());
+	}
+}
+
+//Same as 'ForEachComponent' but the Archetype chunks are
+//spread over 'pool', 'mFunc' is called from many threads.
+template <typename T, typename F>
+void ForEachComponentParallel(EntityManager& manager, ThreadPool& pool, F&& mFunc)
+{
+	const ComponentID id(GetComponentTypeID<T>());
+
+	//One task per chunk, 'ChunkRows' components each.
+	std::vector<std::pair<ComponentColumn*, std::size_t>> chunks;
+	for (auto& a : manager.GetArchetypes())
+	{
+		ComponentColumn* column(a->GetColumn(id));
+		if (column == nullptr)
+			continue;
+
+		for (std::size_t c = 0; c < column->ChunkCount(); ++c)
+			chunks.emplace_back(column, c);
+	}
+
+	pool.ParallelFor(chunks.size(), 1, [&chunks, &mFunc](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i)
+			chunks[i].first->ForEachInChunk<T>(chunks[i].second, mFunc);
+	});
+
+	if (!manager.HasLooseComponents())
+		return;
+
+	for (auto& e : manager.GetEntities())
+	{
+		if (!e->HasComponent<T>())
+			continue;
+
+		Archetype* archetype(e->GetArchetype());
+		if (archetype == nullptr || !archetype->Stores(id))
+			mFunc(e->GetComponent<T>());
+	}
+}
+
+/*
+ * Runs 'T::Update' of every 'T' in one tight loop.
+ *
+ * The call is qualified so it does not go through the
+ * vtable, which lets the compiler inline it. Derive
+ * from this to give a component type its own System.
+ */
+template <typename T>
+class TypedSystem : public System
+{
+public:
+	explicit TypedSystem(std::string mName) :
+		System(std::move(mName), GetComponentBitset<T>())
+	{}
+
+	void Update(EntityManager& manager, float mFT) override
+	{
+		auto update = [mFT](T& c) {
+			c.T::Update(mFT);
+		};
+
+		ThreadPool* pool(manager.GetThreadPool());
+		if (IsParallel() && pool != nullptr)
+			ForEachComponentParallel<T>(manager, *pool, update);
+		else
+			ForEachComponent<T>(manager, update);
+	}
+};
+
+/*
+ * Adapter for components that have no System yet.
+ * Runs their virtual 'Update' like before, skipping
+ * whatever an enabled System already takes care of.
+ */
+class LegacyUpdateSystem final : public System
+{
+public:
+	LegacyUpdateSystem() :
+		System("Legacy", ComponentBitset {})
+	{}
+
+	void Update(EntityManager& manager, float mFT) override
+	{
+		manager.UpdateComponents(mFT);
+	}
+};
+
+}
@@ -0,0 +1,127 @@
+#include "ThreadPool.h"
+
+namespace ComponentSystem
+{
+
+//The pool and queue of the current thread, if it is a worker.
+static thread_local const ThreadPool* currentPool { nullptr };
+static thread_local std::size_t currentQueue { 0 };
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+	for (std::size_t i = 0; i <= threadCount; ++i)
+		queues.emplace_back(std::make_unique<TaskQueue>());
+
+	for (std::size_t i = 0; i < threadCount; ++i)
+	{
+		workers.emplace_back([this, i]() {
+			WorkerLoop(i + 1);
+		});
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (auto& t : workers)
+		t.join();
+}
+
+std::size_t ThreadPool::GetQueueIndex() const noexcept
+{
+	return currentPool == this ? currentQueue : 0;
+}
+
+void ThreadPool::Submit(Task task, TaskCounter& counter)
+{
+	counter.fetch_add(1, std::memory_order_relaxed);
+
+	TaskQueue& queue(*queues[GetQueueIndex()]);
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.emplace_back([task = std::move(task), &counter]() {
+			task();
+			counter.fetch_sub(1, std::memory_order_release);
+		});
+	}
+	queuedTasks.fetch_add(1, std::memory_order_release);
+
+	//Lock so a worker about to sleep can not miss this.
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wake.notify_one();
+}
+
+bool ThreadPool::TryRunTask(std::size_t queueIndex)
+{
+	Task task;
+
+	//Newest task of our own queue, it is likely still in cache.
+	{
+		TaskQueue& own(*queues[queueIndex]);
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+		}
+	}
+
+	//Otherwise steal the oldest task of somebody else.
+	for (std::size_t i = 1; !task && i < queues.size(); ++i)
+	{
+		TaskQueue& other(*queues[(queueIndex + i) % queues.size()]);
+		std::lock_guard<std::mutex> lock(other.mutex);
+		if (!other.tasks.empty())
+		{
+			task = std::move(other.tasks.front());
+			other.tasks.pop_front();
+		}
+	}
+
+	if (!task)
+		return false;
+
+	queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+	task();
+	return true;
+}
+
+void ThreadPool::Wait(TaskCounter& counter)
+{
+	const std::size_t queueIndex(GetQueueIndex());
+	while (counter.load(std::memory_order_acquire) > 0)
+	{
+		//Help out instead of blocking.
+		if (!TryRunTask(queueIndex))
+			std::this_thread::yield();
+	}
+}
+
+void ThreadPool::WorkerLoop(std::size_t queueIndex)
+{
+	currentPool = this;
+	currentQueue = queueIndex;
+
+	while (true)
+	{
+		if (TryRunTask(queueIndex))
+			continue;
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wake.wait(lock, [this]() {
+			return stopping || queuedTasks.load(std::memory_order_acquire) > 0;
+		});
+
+		if (stopping)
+			return;
+	}
+}
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/////////////////////////////////////////////////
+///This file defines ThreadPool, a work-stealing
+///pool used to run Systems on more than one core.
+///
+///Each thread has its own task queue. A thread pops
+///the newest task of its own queue and, when empty,
+///steals the oldest one from the others. Threads
+///waiting on a TaskCounter run tasks meanwhile, so
+///tasks can submit and wait on more tasks.
+///
+///Tasks must not throw.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+//Number of tasks still running, see 'ThreadPool::Wait'.
+using TaskCounter = std::atomic<std::size_t>;
+
+class ThreadPool
+{
+public:
+	using Task = std::function<void()>;
+
+private:
+	struct TaskQueue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	//Queue 0 is shared by every thread outside the pool,
+	//queue 'i + 1' belongs to 'workers[i]'.
+	std::vector<std::unique_ptr<TaskQueue>> queues;
+	std::vector<std::thread> workers;
+
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	std::atomic<std::size_t> queuedTasks { 0 };
+	std::atomic<bool> stopping { false };
+
+	std::size_t GetQueueIndex() const noexcept;
+	bool TryRunTask(std::size_t queueIndex);
+	void WorkerLoop(std::size_t queueIndex);
+
+public:
+	//0 threads runs every task on the caller of 'Wait'.
+	explicit ThreadPool(std::size_t threadCount = DefaultThreadCount());
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//One thread per core, the caller takes the last one.
+	static std::size_t DefaultThreadCount() noexcept
+	{
+		const std::size_t cores(std::thread::hardware_concurrency());
+		return cores > 1 ? cores - 1 : 0;
+	}
+
+	//Threads that can run tasks, the caller included.
+	std::size_t GetConcurrency() const noexcept
+	{
+		return workers.size() + 1;
+	}
+
+	//'counter' is increased now and decreased once 'task' is done.
+	void Submit(Task task, TaskCounter& counter);
+	//Run tasks until 'counter' drops to 0.
+	void Wait(TaskCounter& counter);
+
+	//Split [0, count) in ranges of at least 'grain' and call
+	//'mFunc(begin, end)' on each, returns once all are done.
+	template <typename F>
+	void ParallelFor(std::size_t count, std::size_t grain, F&& mFunc);
+};
+
+template <typename F>
+void ThreadPool::ParallelFor(std::size_t count, std::size_t grain, F&& mFunc)
+{
+	if (grain == 0)
+		grain = 1;
+
+	//No point splitting what one thread does in one go.
+	if (workers.empty() || count <= grain)
+	{
+		if (count > 0)
+			mFunc(std::size_t { 0 }, count);
+		return;
+	}
+
+	//A few ranges per thread so stealing can even things out.
+	const std::size_t wanted(GetConcurrency() * 4);
+	std::size_t step((count + wanted - 1) / wanted);
+	if (step < grain)
+		step = grain;
+
+	TaskCounter counter { 0 };
+	for (std::size_t begin = step; begin < count; begin += step)
+	{
+		const std::size_t end(begin + step < count ? begin + step : count);
+		Submit([&mFunc, begin, end]() {
+			mFunc(begin, end);
+		},
+			counter);
+	}
+
+	//The first range runs right here.
+	mFunc(std::size_t { 0 }, step < count ? step : count);
+	Wait(counter);
+}
+
+}
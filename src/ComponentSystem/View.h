@@ -0,0 +1,86 @@
+#pragma once
+#include "ComponentSystemDefine.h"
+#include "EntityManager.h"
+#include "GameEntity.h"
+
+/////////////////////////////////////////////////
+///This file defines ComponentView, the result of
+///'EntityManager::View<Ts...>()'.
+///
+///A view visits every living entity that has all
+///of 'Ts' and hands over the components already
+///resolved, so callers do not need to check groups
+///or look up each component one by one.
+///
+///Archetypes storing all of 'Ts' are read column
+///by column, other entities are found through
+///their ComponentBitset.
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+template <typename... Ts>
+class ComponentView
+{
+private:
+	EntityManager& manager;
+	ComponentBitset mask;
+
+public:
+	explicit ComponentView(EntityManager& mManager) :
+		manager(mManager),
+		mask(GetComponentBitset<Ts...>())
+	{}
+
+	//Calls 'mFunc(GameEntity&, Ts&...)' for each match.
+	template <typename F>
+	void ForEach(F&& mFunc) const;
+};
+
+template <typename... Ts>
+template <typename F>
+void ComponentView<Ts...>::ForEach(F&& mFunc) const
+{
+	for (auto& a : manager.GetArchetypes())
+	{
+		if ((a->GetSignature() & mask) != mask)
+			continue;
+
+		//No one added some of 'Ts' yet.
+		if (((a->GetColumn(GetComponentTypeID<Ts>()) == nullptr) || ...))
+			continue;
+
+		const auto& rows(a->GetRows());
+		for (std::size_t row = 0; row < rows.size(); ++row)
+		{
+			GameEntity* e(rows[row]);
+			if (e == nullptr || !e->IsAlive() || (e->GetSignature() & mask) != mask)
+				continue;
+
+			mFunc(*e, *static_cast<Ts*>(a->GetColumn(GetComponentTypeID<Ts>())->SlotUnchecked(row))...);
+		}
+	}
+
+	if (!manager.HasLooseComponents())
+		return;
+
+	//Some of 'Ts' are not in the entity's Archetype.
+	for (auto& e : manager.GetEntities())
+	{
+		if (!e->IsAlive() || (e->GetSignature() & mask) != mask)
+			continue;
+
+		Archetype* archetype(e->GetArchetype());
+		if (archetype != nullptr && (archetype->GetSignature() & mask) == mask)
+			continue;
+
+		mFunc(*e, e->GetComponent<Ts>()...);
+	}
+}
+
+template <typename... Ts>
+ComponentView<Ts...> EntityManager::View()
+{
+	return ComponentView<Ts...>(*this);
+}
+
+}
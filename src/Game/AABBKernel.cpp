@@ -0,0 +1,154 @@
+#include "include/AABBKernel.h"
+#include "Utility/CpuFeatures.hpp"
+#include <cstring>
+#ifdef UTIL_X86
+	#include <immintrin.h>
+#endif
+using namespace std;
+
+void AABBBatch::Clear() noexcept
+{
+	Left.clear();
+	Top.clear();
+	Right.clear();
+	Bottom.clear();
+}
+
+void AABBBatch::Add(const AABB& box)
+{
+	Left.emplace_back(box.Left);
+	Top.emplace_back(box.Top);
+	Right.emplace_back(box.Right);
+	Bottom.emplace_back(box.Bottom);
+}
+
+void AABBBatch::SwapRemove(size_t index) noexcept
+{
+	Left[index] = Left.back();
+	Top[index] = Top.back();
+	Right[index] = Right.back();
+	Bottom[index] = Bottom.back();
+	Left.pop_back();
+	Top.pop_back();
+	Right.pop_back();
+	Bottom.pop_back();
+}
+
+namespace
+{
+//Candidates from 'first' on, also finishes what the wide kernels leave over.
+void OverlapScalarFrom(const AABB& box, const AABBBatch& batch, size_t first, uint64_t* hits) noexcept
+{
+	for (size_t i = first; i < batch.Size(); ++i)
+	{
+		const bool hit(box.Right >= batch.Left[i] && box.Left <= batch.Right[i] && box.Bottom >= batch.Top[i] && box.Top <= batch.Bottom[i]);
+		hits[i / 64] |= static_cast<uint64_t>(hit) << (i % 64);
+	}
+}
+
+void OverlapScalar(const AABB& box, const AABBBatch& batch, uint64_t* hits)
+{
+	memset(hits, 0, util::GetHitWords(batch.Size()) * sizeof(uint64_t));
+	OverlapScalarFrom(box, batch, 0, hits);
+}
+
+#ifdef UTIL_X86
+UTIL_TARGET("sse2")
+void OverlapSSE(const AABB& box, const AABBBatch& batch, uint64_t* hits)
+{
+	const size_t count(batch.Size());
+	memset(hits, 0, util::GetHitWords(count) * sizeof(uint64_t));
+
+	const __m128 left(_mm_set1_ps(box.Left));
+	const __m128 top(_mm_set1_ps(box.Top));
+	const __m128 right(_mm_set1_ps(box.Right));
+	const __m128 bottom(_mm_set1_ps(box.Bottom));
+
+	size_t i { 0 };
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 hit(_mm_and_ps(
+			_mm_and_ps(_mm_cmpge_ps(right, _mm_loadu_ps(&batch.Left[i])), _mm_cmple_ps(left, _mm_loadu_ps(&batch.Right[i]))),
+			_mm_and_ps(_mm_cmpge_ps(bottom, _mm_loadu_ps(&batch.Top[i])), _mm_cmple_ps(top, _mm_loadu_ps(&batch.Bottom[i])))));
+		//Four bits never cross a word, 64 is a multiple of four.
+		hits[i / 64] |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << (i % 64);
+	}
+	OverlapScalarFrom(box, batch, i, hits);
+}
+
+UTIL_TARGET("avx2")
+void OverlapAVX2(const AABB& box, const AABBBatch& batch, uint64_t* hits)
+{
+	const size_t count(batch.Size());
+	memset(hits, 0, util::GetHitWords(count) * sizeof(uint64_t));
+
+	const __m256 left(_mm256_set1_ps(box.Left));
+	const __m256 top(_mm256_set1_ps(box.Top));
+	const __m256 right(_mm256_set1_ps(box.Right));
+	const __m256 bottom(_mm256_set1_ps(box.Bottom));
+
+	size_t i { 0 };
+	for (; i + 8 <= count; i += 8)
+	{
+		//Ordered compares, a NaN edge misses like in the scalar test.
+		const __m256 hit(_mm256_and_ps(
+			_mm256_and_ps(_mm256_cmp_ps(right, _mm256_loadu_ps(&batch.Left[i]), _CMP_GE_OQ), _mm256_cmp_ps(left, _mm256_loadu_ps(&batch.Right[i]), _CMP_LE_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(bottom, _mm256_loadu_ps(&batch.Top[i]), _CMP_GE_OQ), _mm256_cmp_ps(top, _mm256_loadu_ps(&batch.Bottom[i]), _CMP_LE_OQ))));
+		hits[i / 64] |= static_cast<uint64_t>(_mm256_movemask_ps(hit)) << (i % 64);
+	}
+	OverlapScalarFrom(box, batch, i, hits);
+}
+#endif
+}
+
+AABBKernel GetAABBKernel(AABBKernelType type) noexcept
+{
+	switch (type)
+	{
+		case AABBKernelType::Scalar:
+			return OverlapScalar;
+#ifdef UTIL_X86
+		case AABBKernelType::SSE:
+			return util::GetCpuFeatures().SSE2 ? OverlapSSE : nullptr;
+		case AABBKernelType::AVX2:
+			return util::GetCpuFeatures().AVX2 ? OverlapAVX2 : nullptr;
+#endif
+		default:
+			return nullptr;
+	}
+}
+
+AABBKernelType GetBestAABBKernelType() noexcept
+{
+	static const AABBKernelType best([]() {
+		for (auto type : { AABBKernelType::AVX2, AABBKernelType::SSE })
+		{
+			if (GetAABBKernel(type) != nullptr)
+				return type;
+		}
+		return AABBKernelType::Scalar;
+	}());
+	return best;
+}
+
+const char* GetAABBKernelName(AABBKernelType type) noexcept
+{
+	switch (type)
+	{
+		case AABBKernelType::Scalar:
+			return "scalar";
+		case AABBKernelType::SSE:
+			return "sse";
+		case AABBKernelType::AVX2:
+			return "avx2";
+		default:
+			return "unknown";
+	}
+}
+
+void OverlapBatch(const AABB& box, const AABBBatch& batch, vector<uint64_t>& hits)
+{
+	static const AABBKernel kernel(GetAABBKernel(GetBestAABBKernelType()));
+	hits.resize(util::GetHitWords(batch.Size()));
+	kernel(box, batch, hits.data());
+}
@@ -0,0 +1,102 @@
+#include "include/AABBTree.h"
+#include <algorithm>
+using namespace std;
+
+namespace
+{
+AABB Merge(const AABB& a, const AABB& b) noexcept
+{
+	return AABB { min(a.Left, b.Left), min(a.Top, b.Top), max(a.Right, b.Right), max(a.Bottom, b.Bottom) };
+}
+}
+
+void AABBTree::Build(const vector<AABB>& boxes)
+{
+	Clear();
+	if (boxes.empty())
+		return;
+
+	items.reserve(boxes.size());
+	for (uint32_t i = 0; i < boxes.size(); ++i)
+		items.emplace_back(Item { boxes[i], i });
+	nodes.reserve(2 * items.size() / LeafSize + 1);
+	BuildNode(0, static_cast<uint32_t>(items.size()));
+}
+
+uint32_t AABBTree::BuildNode(uint32_t first, uint32_t count)
+{
+	const auto index(static_cast<uint32_t>(nodes.size()));
+	AABB bounds(items[first].Box);
+	AABB centers { bounds.Left + bounds.Right, bounds.Top + bounds.Bottom, bounds.Left + bounds.Right, bounds.Top + bounds.Bottom };
+	for (uint32_t i = first + 1; i < first + count; ++i)
+	{
+		const AABB& b(items[i].Box);
+		bounds = Merge(bounds, b);
+		const float cx(b.Left + b.Right);
+		const float cy(b.Top + b.Bottom);
+		centers = Merge(centers, AABB { cx, cy, cx, cy });
+	}
+	nodes.emplace_back(Node { bounds, first, count });
+	if (count <= LeafSize)
+		return index;
+
+	//Median of the centers on the longest axis.
+	const bool splitX(centers.Right - centers.Left >= centers.Bottom - centers.Top);
+	const uint32_t half(count / 2);
+	nth_element(items.begin() + first, items.begin() + first + half, items.begin() + first + count, [splitX](const Item& a, const Item& b) {
+		return splitX ? a.Box.Left + a.Box.Right < b.Box.Left + b.Box.Right
+					  : a.Box.Top + a.Box.Bottom < b.Box.Top + b.Box.Bottom;
+	});
+
+	BuildNode(first, half);
+	const uint32_t right(BuildNode(first + half, count - half));
+	nodes[index].First = right;
+	nodes[index].Count = 0;
+	return index;
+}
+
+void AABBTree::Clear() noexcept
+{
+	nodes.clear();
+	items.clear();
+}
+
+void AABBTree::Query(const AABB& box, vector<uint32_t>& result) const
+{
+	Traverse([&box](const AABB& mBounds) { return ::Overlaps(mBounds, box); },
+		[&box, &result](const Item& mItem) {
+			if (::Overlaps(mItem.Box, box))
+				result.emplace_back(mItem.Id);
+			return false;
+		});
+}
+
+bool AABBTree::Overlaps(const AABB& box) const
+{
+	bool found { false };
+	Traverse([&box](const AABB& mBounds) { return ::Overlaps(mBounds, box); },
+		[&box, &found](const Item& mItem) {
+			found = ::Overlaps(mItem.Box, box);
+			return found;
+		});
+	return found;
+}
+
+bool AABBTree::Raycast(float x, float y, float dx, float dy, RayHit& hit) const
+{
+	//A segment is a box of no size swept along it. Nodes no
+	//closer than the best hit so far are skipped.
+	const AABB origin { x, y, x, y };
+	hit = RayHit { 0, 2.f };
+	Traverse([&origin, dx, dy, &hit](const AABB& mBounds) {
+		float time { 0.f };
+		return SweepAABB(origin, dx, dy, mBounds, time) && time <= hit.Time;
+	},
+		[&origin, dx, dy, &hit](const Item& mItem) {
+			float time { 0.f };
+			if (SweepAABB(origin, dx, dy, mItem.Box, time) && (time < hit.Time || (time == hit.Time && mItem.Id < hit.Id)))
+				hit = RayHit { mItem.Id, time };
+			return false;
+		});
+	return hit.Time <= 1.f;
+}
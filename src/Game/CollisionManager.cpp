@@ -1,4 +1,5 @@
 #include "include/CollisionManager.h"
+#include "ComponentSystem/ThreadPool.h"
 using namespace std;
 using namespace ComponentSystem;
 
@@ -7,6 +8,9 @@ CollisionManager::CollisionManager(ComponentSystem::EntityManager& mManager,
 	manager(mManager),
 	gameDispatcher(mDispatcher)
 {
+	SetBroadphase(broadphaseType);
+	SetDefaultResponses();
+
 	gameDispatcher.appendListener(EventNames::GameStart, [this](const MyEvent&) {
 		stop = false;
 	});
@@ -18,113 +22,235 @@ CollisionManager::CollisionManager(ComponentSystem::EntityManager& mManager,
 	});
 }
 
-void CollisionManager::TestCollision(GameEntity& a, GameEntity& b) noexcept
+AABB CollisionManager::GetBounds(const CPhysics& physics) noexcept
 {
-	if (stop)
-		return;
+	return AABB { physics.Left(), physics.Top(), physics.Right(), physics.Bottom() };
+}
 
-	auto& pA(a.GetComponent<CPhysics>());
-	auto& pB(b.GetComponent<CPhysics>());
+AABB CollisionManager::GetLastStepBounds(const CPhysics& physics) noexcept
+{
+	const sf::Vector2f& p(physics.LastStepPosition);
+	return AABB { p.x - physics.HalfSize.x, p.y - physics.HalfSize.y, p.x + physics.HalfSize.x, p.y + physics.HalfSize.y };
+}
 
-	if (IsIntersecting(pA, pB))
+BroadphaseProxy CollisionManager::MakeProxy(const CPhysics& physics, uint32_t layer, uint32_t mask) noexcept
+{
+	AABB bounds(GetBounds(physics));
+	if (physics.Continuous)
 	{
-		if (a.HasGroup(EntityGroup::Enemy))
-		{
-			auto& cA(a.GetComponent<CSimpleEnemyControl>());
-			auto& statA(a.GetComponent<CStat>());
-			cA.Stop = true;
-
-			if (b.HasGroup(EntityGroup::Player) && !statA.IsDead)
-			{
-				auto& statB(b.GetComponent<CStat>());
-				auto& cB(b.GetComponent<CPlayerControl>());
-				statB.Hit(1);
-
-				if (statB.IsDead)
-				{
-					cB.Stop = true;
-				}
-			}
-		}
+		//Cover the whole path, the narrowphase finds if and when.
+		const AABB last(GetLastStepBounds(physics));
+		bounds = AABB { min(bounds.Left, last.Left), min(bounds.Top, last.Top), max(bounds.Right, last.Right), max(bounds.Bottom, last.Bottom) };
+	}
+	return BroadphaseProxy { bounds, 1u << layer, mask };
+}
 
-		if (b.HasGroup(EntityGroup::Enemy))
-		{
-			auto& cB(b.GetComponent<CSimpleEnemyControl>());
-			auto& statB(b.GetComponent<CStat>());
-			cB.Stop = true;
-
-			if (a.HasGroup(EntityGroup::Player) && !statB.IsDead)
-			{
-				auto& statA(a.GetComponent<CStat>());
-				auto& cA(a.GetComponent<CPlayerControl>());
-
-				statA.Hit(1);
-
-				if (statA.IsDead)
-				{
-					cA.Stop = true;
-				}
-			}
-		}
+bool CollisionManager::IsTouching(const CPhysics& a, const CPhysics& b) noexcept
+{
+	//Proxies of the others are their own boxes, the pair is exact.
+	if (!a.Continuous && !b.Continuous)
+		return true;
 
-		// if (a.HasGroup(EntityGroup::Player) && b.HasGroup(EntityGroup::Obstacle))
-		// {
-		// 	auto& cA(a.GetComponent<CPlayerControl>());
-		// 	cA.Stop = true;
-		// }
-		// else if (b.HasGroup(EntityGroup::Player) && a.HasGroup(EntityGroup::Obstacle))
-		// {
-		// 	auto& cB(b.GetComponent<CPlayerControl>());
-		// 	cB.Stop = true;
-		// }
-
-		if (a.HasGroup(EntityGroup::Projectile) && b.HasGroup(EntityGroup::Enemy))
-		{
-			auto& statB(b.GetComponent<CStat>());
-			auto& pjA(a.GetComponent<CProjectile>());
-
-			if (!statB.IsDead)
-			{
-				statB.Hit(pjA.Damage);
-				a.Destroy();
-			}
-		}
-		else if (b.HasGroup(EntityGroup::Projectile) && a.HasGroup(EntityGroup::Enemy))
-		{
-			auto& statA(a.GetComponent<CStat>());
-			auto& pjB(b.GetComponent<CProjectile>());
-
-			if (!statA.IsDead)
-			{
-				statA.Hit(pjB.Damage);
-				b.Destroy();
-			}
-		}
+	//Move 'a' by how much it moved relative to 'b', from
+	//where both started the last step.
+	const sf::Vector2f delta((a.x() - a.LastStepPosition.x) - (b.x() - b.LastStepPosition.x),
+		(a.y() - a.LastStepPosition.y) - (b.y() - b.LastStepPosition.y));
+	float time { 0.f };
+	return SweepAABB(GetLastStepBounds(a), delta.x, delta.y, GetLastStepBounds(b), time);
+}
+
+void CollisionManager::SetBroadphase(BroadphaseType type)
+{
+	broadphaseType = type;
+	switch (type)
+	{
+		case BroadphaseType::SweepAndPrune:
+			broadphase = make_unique<SweepAndPrune>();
+			break;
+		case BroadphaseType::SpatialHash:
+		default:
+			broadphase = make_unique<SpatialHash>(cellSize);
+			break;
 	}
-	else
+	//Empty until the next test fills the new one.
+	spatialIndex.Clear(broadphase.get());
+}
+
+void CollisionManager::SetCellSize(float size)
+{
+	cellSize = size;
+	if (broadphaseType == BroadphaseType::SpatialHash)
+		SetBroadphase(broadphaseType);
+}
+
+const BroadphaseStats& CollisionManager::GetBroadphaseStats() const noexcept
+{
+	return broadphase->GetStats();
+}
+
+void CollisionManager::SetResponse(EntityGroup a, EntityGroup b, CollisionResponse response)
+{
+	ClearResponse(a, b);
+	matrix.SetCollides(a, b, true);
+
+	const auto index(static_cast<uint32_t>(a * CollisionGroupCount + b));
+	responses[index] = move(response);
+	responseTable[a][b] = ResponseEntry { index, false };
+	if (a != b)
+		responseTable[b][a] = ResponseEntry { index, true };
+}
+
+void CollisionManager::ClearResponse(EntityGroup a, EntityGroup b)
+{
+	matrix.SetCollides(a, b, false);
+	responses[a * CollisionGroupCount + b] = CollisionResponse {};
+	responses[b * CollisionGroupCount + a] = CollisionResponse {};
+	responseTable[a][b] = ResponseEntry {};
+	responseTable[b][a] = ResponseEntry {};
+}
+
+void CollisionManager::SetDefaultResponses()
+{
+	//An enemy stops while it touches a player or a projectile,
+	//a player keeps getting hurt while an enemy touches it.
+	SetResponse(EntityGroup::Enemy, EntityGroup::Player, CollisionResponse {
+		[](GameEntity& mEnemy, GameEntity& mPlayer) {
+			mEnemy.GetComponent<CSimpleEnemyControl>().Stop = true;
+			HitPlayer(mEnemy, mPlayer);
+		},
+		HitPlayer,
+		[this](GameEntity* mEnemy, GameEntity*) {
+			ReleaseEnemy(mEnemy);
+		} });
+
+	SetResponse(EntityGroup::Projectile, EntityGroup::Enemy, CollisionResponse {
+		HitEnemy,
+		nullptr,
+		[this](GameEntity*, GameEntity* mEnemy) {
+			ReleaseEnemy(mEnemy);
+		} });
+}
+
+void CollisionManager::HitPlayer(GameEntity& enemy, GameEntity& player)
+{
+	if (!enemy.GetComponent<CStat>().IsDead)
 	{
-		if (a.HasGroup(EntityGroup::Enemy))
+		auto& stat(player.GetComponent<CStat>());
+		stat.Hit(1);
+
+		if (stat.IsDead)
 		{
-			auto& cA(a.GetComponent<CSimpleEnemyControl>());
-			cA.Stop = false;
+			player.GetComponent<CPlayerControl>().Stop = true;
 		}
+	}
+}
+
+void CollisionManager::HitEnemy(GameEntity& projectile, GameEntity& enemy)
+{
+	enemy.GetComponent<CSimpleEnemyControl>().Stop = true;
 
-		if (b.HasGroup(EntityGroup::Enemy))
+	auto& stat(enemy.GetComponent<CStat>());
+	if (!stat.IsDead)
+	{
+		stat.Hit(projectile.GetComponent<CProjectile>().Damage);
+		projectile.Destroy();
+	}
+}
+
+void CollisionManager::ReleaseEnemy(GameEntity* enemy) const
+{
+	//Still held by another contact.
+	if (enemy != nullptr && !contacts.IsTouching(enemy->GetHandle()))
+		enemy->GetComponent<CSimpleEnemyControl>().Stop = false;
+}
+
+void CollisionManager::CollectColliders()
+{
+	colliders.clear();
+	proxies.clear();
+	spatialIndex.Clear(broadphase.get());
+
+	//An entity in many groups gets a proxy for each, a group
+	//colliding with nothing gets none.
+	for (uint32_t g = 0; g < CollisionGroupCount; ++g)
+	{
+		const uint32_t mask(matrix.GetMask(g));
+		if (mask == 0)
+			continue;
+
+		for (auto& handle : manager.GetEntitiesByGroup(g))
 		{
-			auto& cB(b.GetComponent<CSimpleEnemyControl>());
-			cB.Stop = false;
+			GameEntity& e(manager.GetEntity(handle));
+			if (!e.IsAlive() || !e.HasComponent<CPhysics>())
+				continue;
+
+			CPhysics& physics(e.GetComponent<CPhysics>());
+			if (((blockedGroups >> g) & 1u) != 0 && obstacles.Size() > 0)
+				PushOutOfObstacles(e, physics);
+			colliders.emplace_back(Collider { &e, &physics, g });
+			proxies.emplace_back(MakeProxy(physics, g, mask));
+			spatialIndex.Add(handle, GetBounds(physics));
 		}
+	}
+}
+
+void CollisionManager::RefreshObstacles()
+{
+	const auto& group(manager.GetEntitiesByGroup(EntityGroup::Obstacle));
+	if (group == obstacleHandles)
+		return;
+
+	obstacleHandles = group;
+	obstacleEntities.clear();
+	obstacleBounds.clear();
+	for (auto& handle : group)
+	{
+		GameEntity& e(manager.GetEntity(handle));
+		if (!e.HasComponent<CPhysics>())
+			continue;
+
+		obstacleEntities.emplace_back(handle);
+		obstacleBounds.emplace_back(GetBounds(e.GetComponent<CPhysics>()));
+	}
+	obstacles.Build(obstacleBounds);
+	spatialIndex.SetObstacles(&obstacles, obstacleEntities, obstacleBounds);
+}
+
+bool CollisionManager::HasLineOfSight(const sf::Vector2f& from, const sf::Vector2f& to) const
+{
+	AABBTree::RayHit hit;
+	return !obstacles.Raycast(from.x, from.y, to.x - from.x, to.y - from.y, hit);
+}
+
+void CollisionManager::SetBlockedByObstacles(EntityGroup group, bool blocked) noexcept
+{
+	if (blocked)
+		blockedGroups |= 1u << group;
+	else
+		blockedGroups &= ~(1u << group);
+}
+
+void CollisionManager::PushOutOfObstacles(GameEntity& entity, const CPhysics& physics)
+{
+	blockers.clear();
+	obstacles.Query(GetBounds(physics), blockers);
 
-		// if (a.HasGroup(EntityGroup::Player) && b.HasGroup(EntityGroup::Obstacle))
-		// {
-		// 	auto& cA(a.GetComponent<CPlayerControl>());
-		// 	cA.Stop = false;
-		// }
-		// else if (b.HasGroup(EntityGroup::Player) && a.HasGroup(EntityGroup::Obstacle))
-		// {
-		// 	auto& cB(b.GetComponent<CPlayerControl>());
-		// 	cB.Stop = false;
-		// }
+	sf::Vector2f& position(entity.GetComponent<CTransform>().Position);
+	for (auto id : blockers)
+	{
+		//Out through the closest side, just touching is fine.
+		const AABB box(GetBounds(physics));
+		const AABB& rock(obstacleBounds[id]);
+		const float toLeft(box.Right - rock.Left);
+		const float toRight(rock.Right - box.Left);
+		const float toTop(box.Bottom - rock.Top);
+		const float toBottom(rock.Bottom - box.Top);
+		const float x(toLeft < toRight ? -toLeft : toRight);
+		const float y(toTop < toBottom ? -toTop : toBottom);
+		if (std::abs(x) < std::abs(y))
+			position.x += x;
+		else
+			position.y += y;
 	}
 }
 
@@ -133,44 +259,81 @@ void CollisionManager::TestAllCollision()
 	if (stop)
 		return;
 
-	auto& players(manager.GetEntitiesByGroup(EntityGroup::Player));
-	auto& enemies(manager.GetEntitiesByGroup(EntityGroup::Enemy));
-	//auto& obstacles(manager.GetEntitiesByGroup(EntityGroup::Obstacle));
-	auto& projectiles(manager.GetEntitiesByGroup(EntityGroup::Projectile));
+	RefreshObstacles();
+	CollectColliders();
+	broadphase->Update(proxies);
+	DetectContacts();
+	ResolveContacts();
+}
+
+void CollisionManager::DetectContacts()
+{
+	const size_t count(broadphase->GetPairs().size());
+	contactSlices = (count + PairsPerSlice - 1) / PairsPerSlice;
+	if (contactBuffers.size() < contactSlices)
+		contactBuffers.resize(contactSlices);
 
-	//Enemies only collide with players.
-	for (size_t i = 0; i < enemies.size(); ++i)
+	ThreadPool* pool(manager.GetThreadPool());
+	if (pool == nullptr)
 	{
-		auto& e1(enemies[i]);
-		//Check collisions with all players.
-		for (size_t j = 0; j < players.size(); ++j)
-		{
-			auto& p(players[j]);
-			TestCollision(*e1, *p);
-		}
+		for (size_t s = 0; s < contactSlices; ++s)
+			DetectContacts(s);
+		return;
 	}
 
-	//Players only collide with obstacles.
-	// for (size_t i = 0; i < players.size(); ++i)
-	// {
-	// 	auto& p(players[i]);
-	// 	//Check collisions with all obstacles.
-	// 	for (size_t j = 0; j < obstacles.size(); ++j)
-	// 	{
-	// 		auto& o(obstacles[j]);
-	// 		TestCollision(*p, *o);
-	// 	}
-	// }
-
-	//Projectiles only collide with enemies.
-	for (size_t i = 0; i < projectiles.size(); ++i)
+	pool->ParallelFor(contactSlices, 1, [this](size_t begin, size_t end) {
+		for (size_t s = begin; s < end; ++s)
+			DetectContacts(s);
+	});
+}
+
+void CollisionManager::DetectContacts(size_t slice)
+{
+	const auto& pairs(broadphase->GetPairs());
+	const size_t begin(slice * PairsPerSlice);
+	const size_t end(min(begin + PairsPerSlice, pairs.size()));
+
+	vector<Contact>& found(contactBuffers[slice]);
+	found.clear();
+	for (size_t i = begin; i < end; ++i)
 	{
-		auto& pj(projectiles[i]);
-		//Check collisions with all enemies.
-		for (size_t j = 0; j < enemies.size(); ++j)
-		{
-			auto& e(enemies[j]);
-			TestCollision(*pj, *e);
-		}
+		const Collider* a(&colliders[pairs[i].A]);
+		const Collider* b(&colliders[pairs[i].B]);
+		const ResponseEntry& entry(responseTable[a->Group][b->Group]);
+		if (entry.Response == NoResponse || !IsTouching(*a->Physics, *b->Physics))
+			continue;
+
+		//Same group both ways, order by handle so the key does
+		//not change with the proxy order.
+		if (entry.Swapped || (a->Group == b->Group && b->Entity->GetHandle().Value < a->Entity->GetHandle().Value))
+			swap(a, b);
+		found.emplace_back(Contact { a->Entity->GetHandle(), b->Entity->GetHandle(), entry.Response });
+	}
+}
+
+void CollisionManager::ResolveContacts()
+{
+	for (size_t s = 0; s < contactSlices; ++s)
+	{
+		for (auto& contact : contactBuffers[s])
+			contacts.Add(contact);
 	}
-}
\ No newline at end of file
+
+	//Both are alive while touching, only an exit can miss one.
+	const auto touch = [this](const CollisionCallback& mCallback, const Contact& mContact) {
+		if (mCallback)
+			mCallback(manager.GetEntity(mContact.A), manager.GetEntity(mContact.B));
+	};
+	contacts.Update(
+		[this, &touch](const Contact& mContact) {
+			touch(responses[mContact.Response].OnEnter, mContact);
+		},
+		[this, &touch](const Contact& mContact) {
+			touch(responses[mContact.Response].OnStay, mContact);
+		},
+		[this](const Contact& mContact) {
+			const CollisionExitCallback& onExit(responses[mContact.Response].OnExit);
+			if (onExit)
+				onExit(manager.TryGetEntity(mContact.A), manager.TryGetEntity(mContact.B));
+		});
+}
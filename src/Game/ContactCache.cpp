@@ -0,0 +1,38 @@
+#include "include/ContactCache.h"
+#include <algorithm>
+using namespace std;
+using namespace ComponentSystem;
+
+void ContactCache::SortCurrent()
+{
+	sort(current.begin(), current.end());
+	current.erase(unique(current.begin(), current.end()), current.end());
+
+	touching.clear();
+	for (auto& c : current)
+	{
+		touching.emplace_back(c.A.Value);
+		touching.emplace_back(c.B.Value);
+	}
+	sort(touching.begin(), touching.end());
+	touching.erase(unique(touching.begin(), touching.end()), touching.end());
+}
+
+void ContactCache::FinishUpdate()
+{
+	//Keep both capacities for the next step.
+	previous.swap(current);
+	current.clear();
+}
+
+bool ContactCache::IsTouching(EntityHandle entity) const noexcept
+{
+	return binary_search(touching.begin(), touching.end(), entity.Value);
+}
+
+void ContactCache::Clear() noexcept
+{
+	previous.clear();
+	current.clear();
+	touching.clear();
+}
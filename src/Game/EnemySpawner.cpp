@@ -38,7 +38,7 @@ void EnemySpawner::GenerateChasers(int count)
 	//Init chasers.
 	for (int i = 0; i < count; ++i)
 	{
-		factory.CreateEnemy(center + sf::Vector2f(randomOffestX, randomOffestY), window, 0.8f, EnemyBaseHealth);
+		factory.CreateEnemy(GetSpawnPosition(randomOffestX, randomOffestY), window, 0.8f, EnemyBaseHealth);
 		randomOffestX = RandomX();
 		randomOffestY = RandomY();
 		//cout << randomOffestX << "+" << center.x << "||" << randomOffestY << "+" << center.y << endl;
@@ -56,7 +56,7 @@ void EnemySpawner::GenerateCowards(int count)
 	//Init cowards.
 	for (int i = 0; i < count; ++i)
 	{
-		factory.CreateEnemy(center + sf::Vector2f(randomOffestX, randomOffestY),
+		factory.CreateEnemy(GetSpawnPosition(randomOffestX, randomOffestY),
 			window,
 			1.5f,
 			EnemyMoveType::AvoidPlayer,
@@ -75,7 +75,7 @@ void EnemySpawner::GeneratePongs(int count)
 
 	for (int i = 0; i < count; ++i)
 	{
-		factory.CreateEnemy(center + sf::Vector2f(randomOffestX, randomOffestY),
+		factory.CreateEnemy(GetSpawnPosition(randomOffestX, randomOffestY),
 			window,
 			0.55f,
 			EnemyMoveType::PingPong,
@@ -95,7 +95,7 @@ void EnemySpawner::GenerateChargers(int count)
 
 	for (int i = 0; i < count; ++i)
 	{
-		factory.CreateEnemy(center + sf::Vector2f(randomOffestX, randomOffestY),
+		factory.CreateEnemy(GetSpawnPosition(randomOffestX, randomOffestY),
 			window,
 			1.1f,
 			EnemyMoveType::Charger,
@@ -109,18 +109,30 @@ void EnemySpawner::GenerateChargers(int count)
 	}
 }
 
+void EnemySpawner::Save(ComponentSystem::SnapshotWriter& writer) const
+{
+	writer.Write(center);
+	writer.WriteRandom(randGenerator);
+}
+
+void EnemySpawner::Load(ComponentSystem::SnapshotReader& reader)
+{
+	reader.Read(center);
+	reader.ReadRandom(randGenerator);
+}
+
 int EnemySpawner::RandomX()
 {
-	int result = 0;
-	result = (rand() % (Xmax - Xmin + 1) + Xmin);
+	uniform_int_distribution<int> unif(Xmin, Xmax);
+	int result = unif(randGenerator);
 
 	return result;
 }
 
 int EnemySpawner::RandomY()
 {
-	int result = 0;
-	result = (rand() % (Ymax - Ymin + 1) + Ymin);
+	uniform_int_distribution<int> unif(Ymin, Ymax);
+	int result = unif(randGenerator);
 
 	return result;
 }
@@ -148,4 +160,27 @@ void EnemySpawner::CheckTooClose(int& x, int& y)
 		else
 			y = dangerRadius;
 	}
-}
\ No newline at end of file
+}
+
+sf::Vector2f EnemySpawner::GetSpawnPosition(int& x, int& y)
+{
+	sf::Vector2f position(center + sf::Vector2f(x, y));
+	if (obstacles == nullptr)
+		return position;
+
+	//Give up after a few tries, being pushed out is fine too.
+	for (int i = 0; i < SpawnTries; ++i)
+	{
+		const AABB room { position.x - SpawnClearance, position.y - SpawnClearance, position.x + SpawnClearance, position.y + SpawnClearance };
+		if (!obstacles->Overlaps(room))
+			break;
+
+		x = RandomX();
+		y = RandomY();
+		CheckTooClose(x, y);
+		x *= RandomSign();
+		y *= RandomSign();
+		position = center + sf::Vector2f(x, y);
+	}
+	return position;
+}
@@ -4,15 +4,15 @@ using namespace std;
 
 GameEntity& EntityFactory::CreatePlayer(const sf::Vector2f& position, sf::RenderWindow& target) noexcept
 {
-	auto& player(manager.AddEntity());
+	auto& player(manager.AddEntity(GetComponentBitset<CTransform, CSprite2D, CPhysics, CParticle, CStat, CPlayerControl>()));
 
 	player.AddComponent<CTransform>(position);
 
-	auto& playerSprite(player.AddComponent<CSprite2D>(playerTexturePath, target));
+	auto& playerSprite(player.AddComponent<CSprite2D>(textures, playerTexturePath, target));
 	sf::Vector2f halfSize(playerSprite.Origin);
 
 	player.AddComponent<CPhysics>(halfSize, ScreenWidth, ScreenHeight);
-	player.AddComponent<CParticle>(target);
+	player.AddComponent<CParticle>(particles);
 
 	auto& playerStat(player.AddComponent<CStat>(3, 1, gameDispatcher));
 	playerStat.CanBeProtect = true;
@@ -38,7 +38,7 @@ GameEntity& EntityFactory::CreateEnemy(const sf::Vector2f& position, sf::RenderW
 }
 GameEntity& EntityFactory::CreateEnemy(const sf::Vector2f& position, sf::RenderWindow& target, const float& speedMod, EnemyMoveType moveType, const int& health) noexcept
 {
-	auto& enemy(manager.AddEntity());
+	auto& enemy(manager.AddEntity(GetComponentBitset<CTransform, CSprite2D, CPhysics, CParticle, CStat, CSimpleEnemyControl>()));
 
 	enemy.AddComponent<CTransform>(position);
 
@@ -50,18 +50,17 @@ GameEntity& EntityFactory::CreateEnemy(const sf::Vector2f& position, sf::RenderW
 	else if (moveType == EnemyMoveType::Charger)
 		path = enemyTexturePath4;
 
-	auto& enemySprite(enemy.AddComponent<CSprite2D>(path, target));
+	auto& enemySprite(enemy.AddComponent<CSprite2D>(textures, path, target));
 	sf::Vector2f halfSize(enemySprite.Origin);
 
 	enemy.AddComponent<CPhysics>(halfSize, ScreenWidth, ScreenHeight);
-	enemy.AddComponent<CParticle>(target);
+	enemy.AddComponent<CParticle>(particles);
 
 	auto& enemyStat(enemy.AddComponent<CStat>(health, speedMod, gameDispatcher));
 	enemyStat.CanBeProtect = true;
 
 	auto& players(manager.GetEntitiesByGroup(EntityGroup::Player));
-	sf::Vector2f& playerPos(players[0]->GetComponent<CTransform>().Position);
-	enemy.AddComponent<CSimpleEnemyControl>(EnemyBaseSpeed * enemyStat.SpeedMod, playerPos, moveType);
+	enemy.AddComponent<CSimpleEnemyControl>(EnemyBaseSpeed * enemyStat.SpeedMod, players[0], moveType);
 
 	enemy.AddGroup(EntityGroup::Enemy);
 
@@ -71,33 +70,79 @@ GameEntity& EntityFactory::CreateEnemy(const sf::Vector2f& position, sf::RenderW
 ComponentSystem::GameEntity& EntityFactory::CreateProjectile(const sf::Vector2f& position, const sf::Vector2f& direction,
 	sf::RenderWindow& target, const float& speedMod, const int& damage) noexcept
 {
-	auto& projectile(manager.AddEntity());
+	auto& projectile(manager.AddEntity(GetComponentBitset<CTransform, CSprite2D, CPhysics, CProjectile>()));
+	BuildProjectile(projectile, position, direction, target, speedMod, damage);
 
+	return projectile;
+}
+
+void EntityFactory::QueueProjectile(const sf::Vector2f& position, const sf::Vector2f& direction,
+	sf::RenderWindow& target, const float& speedMod, const int& damage)
+{
+	manager.GetCommandBuffer().Create(GetComponentBitset<CTransform, CSprite2D, CPhysics, CProjectile>(),
+		[this, position, direction, &target, speedMod, damage](GameEntity& mProjectile) {
+			BuildProjectile(mProjectile, position, direction, target, speedMod, damage);
+		});
+}
+
+void EntityFactory::BuildProjectile(GameEntity& projectile, const sf::Vector2f& position, const sf::Vector2f& direction,
+	sf::RenderWindow& target, const float& speedMod, const int& damage) noexcept
+{
 	auto& projectileTransform(projectile.AddComponent<CTransform>(position));
 	projectileTransform.Size = sf::Vector2f(0.25f, 0.25f);
 
-	auto& projectileSprite(projectile.AddComponent<CSprite2D>(playerTexturePath, target));
+	auto& projectileSprite(projectile.AddComponent<CSprite2D>(textures, playerTexturePath, target));
 	sf::Vector2f halfSize(projectileSprite.Origin);
 
-	projectile.AddComponent<CPhysics>(halfSize, ScreenWidth, ScreenHeight);
+	//Fast and small, it could skip over an enemy in one step.
+	projectile.AddComponent<CPhysics>(halfSize, ScreenWidth, ScreenHeight).Continuous = true;
 	projectile.AddComponent<CProjectile>(BulletBaseSpeed * speedMod, direction, damage);
 
 	projectile.AddGroup(EntityGroup::Projectile);
-
-	return projectile;
 }
 
 ComponentSystem::GameEntity& EntityFactory::CreateObstacle(const sf::Vector2f& position, sf::RenderWindow& target) noexcept
 {
-	auto& obstacle(manager.AddEntity());
+	auto& obstacle(manager.AddEntity(GetComponentBitset<CTransform, CSprite2D, CPhysics>()));
 
 	obstacle.AddComponent<CTransform>(position);
 
-	auto& obstacleSprite(obstacle.AddComponent<CSprite2D>(rockTexturePath, target));
+	auto& obstacleSprite(obstacle.AddComponent<CSprite2D>(textures, rockTexturePath, target));
 	sf::Vector2f halfSize(obstacleSprite.Origin);
 
 	obstacle.AddComponent<CPhysics>(halfSize, ScreenWidth, ScreenHeight);
 	obstacle.AddGroup(EntityGroup::Obstacle);
 
 	return obstacle;
-}
\ No newline at end of file
+}
+
+Component* EntityFactory::LoadComponent(GameEntity& entity, ComponentID id, SnapshotReader& reader, sf::RenderWindow& target)
+{
+	//Construct with anything, 'Load' overwrites the state.
+	switch (id)
+	{
+		case GetComponentTypeID<CCounter>():
+			return &entity.AddComponent<CCounter>();
+		case GetComponentTypeID<CTransform>():
+			return &entity.AddComponent<CTransform>();
+		case GetComponentTypeID<CSprite2D>():
+			return &entity.AddComponent<CSprite2D>(textures, reader.ReadString(), target);
+		case GetComponentTypeID<CParticle>():
+			return &entity.AddComponent<CParticle>(particles);
+		case GetComponentTypeID<CStat>():
+			return &entity.AddComponent<CStat>(0, 1.f, gameDispatcher);
+		case GetComponentTypeID<CPhysics>():
+			return &entity.AddComponent<CPhysics>(sf::Vector2f(), ScreenWidth, ScreenHeight);
+		case GetComponentTypeID<CPlayerControl>():
+			return &entity.AddComponent<CPlayerControl>(PlayerBaseSpeed);
+		case GetComponentTypeID<CSimpleEnemyControl>():
+			return &entity.AddComponent<CSimpleEnemyControl>(EnemyBaseSpeed, NullEntity);
+		case GetComponentTypeID<CProjectile>():
+			return &entity.AddComponent<CProjectile>(BulletBaseSpeed, sf::Vector2f());
+		case GetComponentTypeID<CReceiver>():
+			return &entity.AddComponent<CReceiver>();
+		default:
+			//CConsumable can not be added by anyone yet.
+			return nullptr;
+	}
+}
@@ -29,14 +29,27 @@ void Game ::Init()
 	timePoint1 = std::chrono::steady_clock::now();
 	timePoint2 = std::chrono::steady_clock::now();
 
+	//Build the update pipeline. Controllers run in the
+	//legacy step and must set velocities before physics.
+	manager.SetThreadPool(&threadPool);
+	manager.AddSystem<EnemyAISystem>();
+	manager.AddSystem<LegacyUpdateSystem>();
+	manager.AddSystem<PhysicsSystem>();
+	manager.AddSystem<StatSystem>();
+	manager.AddSystem<SpriteSyncSystem>();
+
 	//Create entity factory.
-	this->entityFactory = new EntityFactory(manager, gameDispatcher);
+	this->entityFactory = new EntityFactory(manager, gameDispatcher, textures, particles);
+	//Without an atlas every sprite uses its own file.
+	textures.LoadAtlas(atlasManifestPath);
+	manager.AddSystem<ParticleSystem>(particles);
 
 	//Create collision manager.
 	this->collisionManager = new CollisionManager(manager, gameDispatcher);
 
 	//Create enemy Spawner.
 	this->enemySpawner = new EnemySpawner(*entityFactory, *window);
+	enemySpawner->SetObstacles(&collisionManager->GetObstacles());
 
 	//Create Game Timer.
 	this->gameClock = new GameClock(gameDispatcher);
@@ -63,7 +76,6 @@ void Game ::Init()
 
 void Game::InitLevel()
 {
-	//GenerateLevel();
 	gameClock->StartTimer(DefaultTimeLimit);
 	hudManager->Reset();
 }
@@ -71,10 +83,8 @@ void Game::InitLevel()
 void Game::InitPlayer()
 {
 	auto& player(entityFactory->CreatePlayer(sf::Vector2f(ScreenWidth / 2, ScreenHeight / 2), *window));
-	auto& tPlayer(player.GetComponent<CTransform>());
-	sf::Vector2f& playerPos(tPlayer.Position);
 
-	this->playerWeapon = new WeaponController(WeaponType::Gun, *entityFactory, manager, gameDispatcher, *window, playerPos);
+	this->playerWeapon = new WeaponController(WeaponType::Gun, *entityFactory, manager, gameDispatcher, *window, player.GetHandle());
 }
 
 void Game::InitEnemy()
@@ -99,6 +109,9 @@ void Game::GenerateLevel()
 		randomOffestX = unif(generator);
 		randomOffestY = unif(generator);
 	}
+
+	//So the first wave already spawns around them.
+	collisionManager->RefreshObstacles();
 }
 
 void Game::GenerateEnemyWave()
@@ -125,8 +138,8 @@ void Game::GenerateEnemyWave()
 		spawnLock = true;
 
 		auto& players(manager.GetEntitiesByGroup(EntityGroup::Player));
-		auto& player(players[0]);
-		auto& pT(player->GetComponent<CTransform>());
+		auto& player(manager.GetEntity(players[0]));
+		auto& pT(player.GetComponent<CTransform>());
 		sf::Vector2f& playerPos(pT.Position);
 		enemySpawner->SetCenter(playerPos);
 		enemySpawner->GenerateEnemy(currentSpawnCount, currentWaveMode);
@@ -158,12 +171,31 @@ void Game::PollingEvent()
 					if (GameState != GameStates::Stage)
 					{
 						ClearStage();
+						GenerateLevel();
 						InitPlayer();
 						InitEnemy();
 						gameDispatcher.dispatch(MyEvent { EventNames::GameStart, "Game Start", 0 });
 						InitLevel();
 					}
 				}
+				else if (event.key.code == sf::Keyboard::F2)
+				{
+					//Compare broadphases on the same wave.
+					if (collisionManager->GetBroadphaseType() == BroadphaseType::SpatialHash)
+						collisionManager->SetBroadphase(BroadphaseType::SweepAndPrune);
+					else
+						collisionManager->SetBroadphase(BroadphaseType::SpatialHash);
+				}
+				else if (event.key.code == sf::Keyboard::F5)
+				{
+					if (GameState == GameStates::Stage)
+						SaveStage();
+				}
+				else if (event.key.code == sf::Keyboard::F9)
+				{
+					if (GameState == GameStates::Stage)
+						RestoreStage();
+				}
 				break;
 			default:
 				break;
@@ -177,34 +209,36 @@ void Game::ClearStage()
 	auto& players(manager.GetEntitiesByGroup(EntityGroup::Player));
 	for (size_t i = 0; i < players.size(); ++i)
 	{
-		auto& p(players[i]);
-		p->Destroy();
+		auto& p(manager.GetEntity(players[i]));
+		p.Destroy();
 	}
 
 	//Clear Enemies
 	auto& enemies(manager.GetEntitiesByGroup(EntityGroup::Enemy));
 	for (size_t i = 0; i < enemies.size(); ++i)
 	{
-		auto& e(enemies[i]);
-		e->Destroy();
+		auto& e(manager.GetEntity(enemies[i]));
+		e.Destroy();
 	}
 
 	//Clear Projectiles
 	auto& projectiles(manager.GetEntitiesByGroup(EntityGroup::Projectile));
 	for (size_t i = 0; i < projectiles.size(); ++i)
 	{
-		auto& pj(projectiles[i]);
-		pj->Destroy();
+		auto& pj(manager.GetEntity(projectiles[i]));
+		pj.Destroy();
 	}
 
 	//Clear Obstacles
 	auto& obstacles(manager.GetEntitiesByGroup(EntityGroup::Obstacle));
 	for (size_t i = 0; i < obstacles.size(); ++i)
 	{
-		auto& o(obstacles[i]);
-		o->Destroy();
+		auto& o(manager.GetEntity(obstacles[i]));
+		o.Destroy();
 	}
 	manager.Refresh(); //MUST DO THIS so that entities really get deteled.
+	collisionManager->ClearContacts();
+	particles.Clear();
 }
 
 void Game::PauseStage()
@@ -212,12 +246,69 @@ void Game::PauseStage()
 	auto& enemies(manager.GetEntitiesByGroup(EntityGroup::Enemy));
 	for (size_t i = 0; i < enemies.size(); ++i)
 	{
-		auto& e(enemies[i]);
-		auto& cE(e->GetComponent<CSimpleEnemyControl>());
+		auto& e(manager.GetEntity(enemies[i]));
+		auto& cE(e.GetComponent<CSimpleEnemyControl>());
 		cE.Stop = true;
 	}
 }
 
+void Game::SaveStage()
+{
+	stageSnapshot.Clear();
+	manager.SaveSnapshot(stageSnapshot);
+
+	//Wave state follows the entities.
+	stageSnapshot.Write(currentSpawnCount);
+	stageSnapshot.Write(spawnLock);
+	stageSnapshot.Write(currentWaveMode);
+	enemySpawner->Save(stageSnapshot);
+
+	stageSnapshot.SaveToFile(SnapshotPath);
+}
+
+void Game::RestoreStage()
+{
+	//Fall back to the file, e.g. one left by a crash.
+	std::vector<char> file;
+	if (stageSnapshot.GetBuffer().empty() && !SnapshotReader::LoadFile(SnapshotPath, file))
+		return;
+
+	SnapshotReader reader(stageSnapshot.GetBuffer().empty() ? file : stageSnapshot.GetBuffer());
+	const bool loaded(manager.LoadSnapshot(reader, [this](GameEntity& mEntity, ComponentID mID, SnapshotReader& mReader) {
+		return entityFactory->LoadComponent(mEntity, mID, mReader, *window);
+	}));
+	collisionManager->ClearContacts();
+	particles.Clear();
+	if (loaded)
+	{
+		reader.Read(currentSpawnCount);
+		reader.Read(spawnLock);
+		reader.Read(currentWaveMode);
+		enemySpawner->Load(reader);
+	}
+
+	if (!loaded || !reader.IsValid())
+	{
+		std::cout << "Error! Snapshot is broken!" << std::endl;
+		//A broken table leaves the stage as it was, a broken
+		//component leaves it empty and a cut off wave state
+		//leaves it half restored, start a new one then.
+		if (loaded || manager.GetEntitiesByGroup(EntityGroup::Player).empty())
+		{
+			ClearStage();
+			GenerateLevel();
+			InitPlayer();
+			InitEnemy();
+			InitLevel();
+		}
+		return;
+	}
+
+	auto& players(manager.GetEntitiesByGroup(EntityGroup::Player));
+	if (playerWeapon != nullptr && !players.empty())
+		playerWeapon->SetOwner(players[0]);
+}
+
 void Game::OnGameStateChange(EventNames state)
 {
 	switch (state)
@@ -299,7 +390,12 @@ void Game::Render()
 	//clear previous frame
 	this->window->clear();
 
-	manager.Render();
+	//Sprites go in one draw per texture, the rest draws itself.
+	spriteBatch.Clear();
+	spriteBatch.AddSprites(manager);
+	spriteBatch.Draw(*window);
+	manager.Render(GetComponentBitset<CSprite2D>());
+	particles.Draw(*window);
 	gameClock->DrawText(*window);
 	hudManager->DrawHUD(*window);
 
@@ -331,8 +427,11 @@ void Game::Run()
 		//Note: these are just for monitoring performance.
 		frameTimeSeconds = (frameTime / 1000.f);
 		framePerSecond = (1.f / frameTimeSeconds);
+		const BroadphaseStats& collision(collisionManager->GetBroadphaseStats());
 		window->setTitle(
-			"[Polygon Survivors] FrameTime: " + to_string(frameTimeSeconds) + " / FPS: " + to_string(framePerSecond));
+			"[Polygon Survivors] FrameTime: " + to_string(frameTimeSeconds) + " / FPS: " + to_string(framePerSecond)
+			+ " / Pairs: " + to_string(collision.Pairs) + "/" + to_string(collision.Candidates)
+			+ " / " + collisionManager->GetBroadphase().GetName() + ": " + to_string(collision.BuildMs) + "ms");
 	}
 	//#pragma endregion
 }
\ No newline at end of file
@@ -83,8 +83,8 @@ void HUDManager::Reset()
 	currentScore = 0;
 
 	auto& players(manager.GetEntitiesByGroup(EntityGroup::Player));
-	auto& p(players[0]);
-	auto& pStat(p->GetComponent<CStat>());
+	auto& p(manager.GetEntity(players[0]));
+	auto& pStat(p.GetComponent<CStat>());
 
 	currentHealth = pStat.Health;
 	UpdateScore();
@@ -0,0 +1,241 @@
+#include "include/ParticleKernel.h"
+#include "Utility/BitMask.hpp"
+#include "Utility/CpuFeatures.hpp"
+#include "include/GlobalGameSettings.h"
+#include <cstring>
+#ifdef UTIL_X86
+	#include <immintrin.h>
+#endif
+using namespace std;
+
+//Faded below this a particle is gone.
+constexpr float MinParticleAlpha { 10.f };
+
+void ParticleBatch::Reserve(size_t capacity)
+{
+	for (auto* field : { &X, &Y, &VelocityX, &VelocityY, &GravityX, &GravityY, &Speed, &Alpha, &Fade })
+		field->reserve(capacity);
+	Color.reserve(capacity);
+}
+
+void ParticleBatch::Clear() noexcept
+{
+	Shrink(0);
+}
+
+void ParticleBatch::Add(const Particle& particle)
+{
+	X.emplace_back(particle.Position.x);
+	Y.emplace_back(particle.Position.y);
+	VelocityX.emplace_back(particle.Velocity.x);
+	VelocityY.emplace_back(particle.Velocity.y);
+	GravityX.emplace_back(particle.Gravity.x);
+	GravityY.emplace_back(particle.Gravity.y);
+	Speed.emplace_back(particle.Speed);
+	Alpha.emplace_back(particle.Color.a);
+	Fade.emplace_back(particle.Fade);
+	Color.emplace_back(particle.Color);
+}
+
+void ParticleBatch::Move(size_t from, size_t to) noexcept
+{
+	for (auto* field : { &X, &Y, &VelocityX, &VelocityY, &GravityX, &GravityY, &Speed, &Alpha, &Fade })
+		(*field)[to] = (*field)[from];
+	Color[to] = Color[from];
+}
+
+void ParticleBatch::Shrink(size_t count) noexcept
+{
+	//Never grows, so nothing is allocated.
+	for (auto* field : { &X, &Y, &VelocityX, &VelocityY, &GravityX, &GravityY, &Speed, &Alpha, &Fade })
+		field->erase(field->begin() + count, field->end());
+	Color.erase(Color.begin() + count, Color.end());
+}
+
+namespace
+{
+//Particles from 'first' on, also finishes what the wide kernels leave over.
+//The wide kernels do the same operations in the same order, so they give
+//the very same floats.
+void IntegrateScalarFrom(ParticleBatch& b, float mFT, size_t first, uint64_t* alive) noexcept
+{
+	for (size_t i = first; i < b.Size(); ++i)
+	{
+		b.VelocityX[i] += b.GravityX[i] * mFT;
+		b.VelocityY[i] += b.GravityY[i] * mFT;
+		const float step(mFT * b.Speed[i]);
+		b.X[i] += b.VelocityX[i] * step;
+		b.Y[i] += b.VelocityY[i] * step;
+		b.Alpha[i] = max(0.f, b.Alpha[i] - b.Fade[i]);
+
+		const bool live(b.X[i] >= 0.f && b.X[i] <= ScreenWidth && b.Y[i] >= 0.f && b.Y[i] <= ScreenHeight && b.Alpha[i] >= MinParticleAlpha);
+		alive[i / 64] |= static_cast<uint64_t>(live) << (i % 64);
+	}
+}
+
+void IntegrateScalar(ParticleBatch& batch, float mFT, uint64_t* alive)
+{
+	memset(alive, 0, util::GetHitWords(batch.Size()) * sizeof(uint64_t));
+	IntegrateScalarFrom(batch, mFT, 0, alive);
+}
+
+#ifdef UTIL_X86
+UTIL_TARGET("sse2")
+void IntegrateSSE(ParticleBatch& b, float mFT, uint64_t* alive)
+{
+	const size_t count(b.Size());
+	memset(alive, 0, util::GetHitWords(count) * sizeof(uint64_t));
+
+	const __m128 ft(_mm_set1_ps(mFT));
+	const __m128 zero(_mm_setzero_ps());
+	const __m128 width(_mm_set1_ps(ScreenWidth));
+	const __m128 height(_mm_set1_ps(ScreenHeight));
+	const __m128 minAlpha(_mm_set1_ps(MinParticleAlpha));
+
+	size_t i { 0 };
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 vx(_mm_add_ps(_mm_loadu_ps(&b.VelocityX[i]), _mm_mul_ps(_mm_loadu_ps(&b.GravityX[i]), ft)));
+		const __m128 vy(_mm_add_ps(_mm_loadu_ps(&b.VelocityY[i]), _mm_mul_ps(_mm_loadu_ps(&b.GravityY[i]), ft)));
+		const __m128 step(_mm_mul_ps(ft, _mm_loadu_ps(&b.Speed[i])));
+		const __m128 x(_mm_add_ps(_mm_loadu_ps(&b.X[i]), _mm_mul_ps(vx, step)));
+		const __m128 y(_mm_add_ps(_mm_loadu_ps(&b.Y[i]), _mm_mul_ps(vy, step)));
+		//Same argument order as 'std::max(0.f, a)'.
+		const __m128 alpha(_mm_max_ps(zero, _mm_sub_ps(_mm_loadu_ps(&b.Alpha[i]), _mm_loadu_ps(&b.Fade[i]))));
+		_mm_storeu_ps(&b.VelocityX[i], vx);
+		_mm_storeu_ps(&b.VelocityY[i], vy);
+		_mm_storeu_ps(&b.X[i], x);
+		_mm_storeu_ps(&b.Y[i], y);
+		_mm_storeu_ps(&b.Alpha[i], alpha);
+
+		const __m128 live(_mm_and_ps(
+			_mm_and_ps(_mm_and_ps(_mm_cmpge_ps(x, zero), _mm_cmple_ps(x, width)), _mm_and_ps(_mm_cmpge_ps(y, zero), _mm_cmple_ps(y, height))),
+			_mm_cmpge_ps(alpha, minAlpha)));
+		//Four bits never cross a word, 64 is a multiple of four.
+		alive[i / 64] |= static_cast<uint64_t>(_mm_movemask_ps(live)) << (i % 64);
+	}
+	IntegrateScalarFrom(b, mFT, i, alive);
+}
+
+UTIL_TARGET("avx2")
+void IntegrateAVX2(ParticleBatch& b, float mFT, uint64_t* alive)
+{
+	const size_t count(b.Size());
+	memset(alive, 0, util::GetHitWords(count) * sizeof(uint64_t));
+
+	const __m256 ft(_mm256_set1_ps(mFT));
+	const __m256 zero(_mm256_setzero_ps());
+	const __m256 width(_mm256_set1_ps(ScreenWidth));
+	const __m256 height(_mm256_set1_ps(ScreenHeight));
+	const __m256 minAlpha(_mm256_set1_ps(MinParticleAlpha));
+
+	size_t i { 0 };
+	for (; i + 8 <= count; i += 8)
+	{
+		//No FMA, it would round differently from the scalar kernel.
+		const __m256 vx(_mm256_add_ps(_mm256_loadu_ps(&b.VelocityX[i]), _mm256_mul_ps(_mm256_loadu_ps(&b.GravityX[i]), ft)));
+		const __m256 vy(_mm256_add_ps(_mm256_loadu_ps(&b.VelocityY[i]), _mm256_mul_ps(_mm256_loadu_ps(&b.GravityY[i]), ft)));
+		const __m256 step(_mm256_mul_ps(ft, _mm256_loadu_ps(&b.Speed[i])));
+		const __m256 x(_mm256_add_ps(_mm256_loadu_ps(&b.X[i]), _mm256_mul_ps(vx, step)));
+		const __m256 y(_mm256_add_ps(_mm256_loadu_ps(&b.Y[i]), _mm256_mul_ps(vy, step)));
+		const __m256 alpha(_mm256_max_ps(zero, _mm256_sub_ps(_mm256_loadu_ps(&b.Alpha[i]), _mm256_loadu_ps(&b.Fade[i]))));
+		_mm256_storeu_ps(&b.VelocityX[i], vx);
+		_mm256_storeu_ps(&b.VelocityY[i], vy);
+		_mm256_storeu_ps(&b.X[i], x);
+		_mm256_storeu_ps(&b.Y[i], y);
+		_mm256_storeu_ps(&b.Alpha[i], alpha);
+
+		//Ordered compares, a NaN position is dead like in the scalar test.
+		const __m256 live(_mm256_and_ps(
+			_mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(x, zero, _CMP_GE_OQ), _mm256_cmp_ps(x, width, _CMP_LE_OQ)),
+				_mm256_and_ps(_mm256_cmp_ps(y, zero, _CMP_GE_OQ), _mm256_cmp_ps(y, height, _CMP_LE_OQ))),
+			_mm256_cmp_ps(alpha, minAlpha, _CMP_GE_OQ)));
+		alive[i / 64] |= static_cast<uint64_t>(_mm256_movemask_ps(live)) << (i % 64);
+	}
+	IntegrateScalarFrom(b, mFT, i, alive);
+}
+#endif
+}
+
+ParticleKernel GetParticleKernel(ParticleKernelType type) noexcept
+{
+	switch (type)
+	{
+		case ParticleKernelType::Scalar:
+			return IntegrateScalar;
+#ifdef UTIL_X86
+		case ParticleKernelType::SSE:
+			return util::GetCpuFeatures().SSE2 ? IntegrateSSE : nullptr;
+		case ParticleKernelType::AVX2:
+			return util::GetCpuFeatures().AVX2 ? IntegrateAVX2 : nullptr;
+#endif
+		default:
+			return nullptr;
+	}
+}
+
+ParticleKernelType GetBestParticleKernelType() noexcept
+{
+	static const ParticleKernelType best([]() {
+		for (auto type : { ParticleKernelType::AVX2, ParticleKernelType::SSE })
+		{
+			if (GetParticleKernel(type) != nullptr)
+				return type;
+		}
+		return ParticleKernelType::Scalar;
+	}());
+	return best;
+}
+
+const char* GetParticleKernelName(ParticleKernelType type) noexcept
+{
+	switch (type)
+	{
+		case ParticleKernelType::Scalar:
+			return "scalar";
+		case ParticleKernelType::SSE:
+			return "sse";
+		case ParticleKernelType::AVX2:
+			return "avx2";
+		default:
+			return "unknown";
+	}
+}
+
+size_t CompactParticles(ParticleBatch& batch, const vector<uint64_t>& alive) noexcept
+{
+	const size_t count(batch.Size());
+	size_t kept { 0 };
+	for (size_t w = 0; w < util::GetHitWords(count); ++w)
+	{
+		const size_t first(w * 64);
+		const size_t inWord(min<size_t>(64, count - first));
+		const uint64_t all(inWord == 64 ? ~uint64_t { 0 } : (uint64_t { 1 } << inWord) - 1);
+
+		//Nobody died up to here, the whole word stays put.
+		if (kept == first && alive[w] == all)
+		{
+			kept += inWord;
+			continue;
+		}
+
+		for (uint64_t bits = alive[w]; bits != 0; bits &= bits - 1)
+		{
+			const size_t i(first + util::GetLowestBit(bits));
+			if (i != kept)
+				batch.Move(i, kept);
+			++kept;
+		}
+	}
+
+	batch.Shrink(kept);
+	return kept;
+}
+
+void UpdateParticles(ParticleBatch& batch, float mFT, vector<uint64_t>& alive)
+{
+	static const ParticleKernel kernel(GetParticleKernel(GetBestParticleKernelType()));
+	alive.resize(util::GetHitWords(batch.Size()));
+	kernel(batch, mFT, alive.data());
+	CompactParticles(batch, alive);
+}
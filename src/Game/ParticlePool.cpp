@@ -0,0 +1,94 @@
+#include "include/ParticlePool.h"
+#include "Utility/BitMask.hpp"
+using namespace std;
+
+ParticlePool::ParticlePool(size_t mCapacity) :
+	capacity(mCapacity)
+{
+	particles.Reserve(capacity);
+	alive.reserve(util::GetHitWords(capacity));
+}
+
+ParticlePool::EmitterID ParticlePool::CreateEmitter()
+{
+	if (freeEmitters.empty())
+	{
+		emitters.emplace_back();
+		return static_cast<EmitterID>(emitters.size() - 1);
+	}
+
+	const EmitterID id(freeEmitters.back());
+	freeEmitters.pop_back();
+	emitters[id] = ParticleEmitter {};
+	return id;
+}
+
+void ParticlePool::DestroyEmitter(EmitterID id)
+{
+	freeEmitters.emplace_back(id);
+}
+
+size_t ParticlePool::Burst(EmitterID id, int count)
+{
+	ParticleEmitter& e(emitters[id]);
+	uniform_real_distribution<float> angle(0.f, 6.2832f);
+	uniform_real_distribution<float> unit(0.f, 1.f);
+	uniform_real_distribution<float> signedUnit(-1.f, 1.f);
+
+	size_t spawned { 0 };
+	for (int i = 0; i < count && particles.Size() < capacity; ++i)
+	{
+		Particle p { e.Position, sf::Vector2f(), e.Gravity, e.Speed, 0.f, sf::Color(e.Color.r, e.Color.g, e.Color.b, 255) };
+		switch (e.ShapeType)
+		{
+			case Shape::CIRCLE:
+			{
+				e.Dissolve = true;
+				const float a(angle(random));
+				p.Velocity.x = cos(a) * unit(random);
+				p.Velocity.y = sin(a) * unit(random);
+				break;
+			}
+			case Shape::SQUARE:
+				e.Dissolve = false;
+				p.Velocity.x = signedUnit(random);
+				p.Velocity.y = signedUnit(random);
+				break;
+			default:
+				p.Velocity.x = 0.5f; // Easily detected
+				p.Velocity.y = 0.5f; // Easily detected
+		}
+
+		if (p.Velocity.x == 0.0f && p.Velocity.y == 0.0f)
+			continue;
+
+		p.Fade = e.Dissolve ? e.DissolutionRate : 0.f;
+		particles.Add(p);
+		++spawned;
+	}
+	return spawned;
+}
+
+void ParticlePool::Update(float mFT)
+{
+	UpdateParticles(particles, mFT, alive);
+}
+
+void ParticlePool::Draw(sf::RenderTarget& target)
+{
+	if (particles.Size() == 0)
+		return;
+
+	vertices.resize(particles.Size());
+	for (size_t i = 0; i < particles.Size(); ++i)
+	{
+		const sf::Color& c(particles.Color[i]);
+		vertices[i] = sf::Vertex(sf::Vector2f(particles.X[i], particles.Y[i]), sf::Color(c.r, c.g, c.b, static_cast<sf::Uint8>(particles.Alpha[i])));
+	}
+	target.draw(vertices);
+}
+
+void ParticlePool::Clear() noexcept
+{
+	particles.Clear();
+}
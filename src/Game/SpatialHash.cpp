@@ -0,0 +1,176 @@
+#include "include/SpatialHash.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+using namespace std;
+
+SpatialHash::SpatialHash(float mCellSize)
+{
+	SetCellSize(mCellSize);
+}
+
+void SpatialHash::SetCellSize(float mCellSize) noexcept
+{
+	cellSize = mCellSize > 1.f ? mCellSize : 1.f;
+	inverseCellSize = 1.f / cellSize;
+}
+
+SpatialHash::CellRange SpatialHash::GetCellRange(const AABB& box) const noexcept
+{
+	//Clamped as floats, casting one out of range is undefined.
+	const auto cell = [this](float v) {
+		return static_cast<int>(max(-static_cast<float>(MaxCell), min(static_cast<float>(MaxCell), floor(v * inverseCellSize))));
+	};
+	return CellRange { cell(box.Left), cell(box.Top), cell(box.Right), cell(box.Bottom) };
+}
+
+uint64_t SpatialHash::GetCellCount(const CellRange& range) noexcept
+{
+	return static_cast<uint64_t>(range.MaxX - range.MinX + 1) * static_cast<uint64_t>(range.MaxY - range.MinY + 1);
+}
+
+uint32_t SpatialHash::GetBucket(int x, int y) const noexcept
+{
+	//Large primes so neighbour cells land far apart.
+	const uint32_t hash((static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u));
+	return hash & bucketMask;
+}
+
+void SpatialHash::NextStamp() noexcept
+{
+	if (++stamp == 0)
+	{
+		fill(stamps.begin(), stamps.end(), 0);
+		stamp = 1;
+	}
+}
+
+template <typename F>
+void SpatialHash::ForEachNearby(const AABB& box, F&& mFunc)
+{
+	NextStamp();
+
+	//Bigger than the whole grid, just read every proxy.
+	const CellRange range(GetCellRange(box));
+	if (GetCellCount(range) > entries.size())
+	{
+		for (uint32_t i = 0; i < proxies.size(); ++i)
+			mFunc(i);
+		return;
+	}
+
+	for (auto id : oversized)
+	{
+		stamps[id] = stamp;
+		mFunc(id);
+	}
+
+	for (int y = range.MinY; y <= range.MaxY; ++y)
+	{
+		for (int x = range.MinX; x <= range.MaxX; ++x)
+		{
+			const uint32_t bucket(GetBucket(x, y));
+			for (uint32_t k = bucketStarts[bucket]; k < bucketStarts[bucket + 1]; ++k)
+			{
+				const uint32_t id(bucketIds[k]);
+				if (stamps[id] == stamp)
+					continue;
+
+				stamps[id] = stamp;
+				mFunc(id);
+			}
+		}
+	}
+}
+
+void SpatialHash::Update(const vector<BroadphaseProxy>& mProxies)
+{
+	const auto start(chrono::steady_clock::now());
+	stats = BroadphaseStats {};
+	pairs.clear();
+
+	proxies = mProxies;
+	oversized.clear();
+	size_t cellCount { 0 };
+	for (uint32_t i = 0; i < proxies.size(); ++i)
+	{
+		const uint64_t cells(GetCellCount(GetCellRange(proxies[i].Bounds)));
+		if (cells > MaxProxyCells)
+			oversized.emplace_back(i);
+		else
+			cellCount += static_cast<size_t>(cells);
+	}
+
+	//About two buckets per entry keeps collisions rare.
+	size_t bucketCount(16);
+	while (bucketCount < cellCount * 2 && bucketCount < MaxBuckets)
+		bucketCount <<= 1;
+	bucketMask = static_cast<uint32_t>(bucketCount - 1);
+
+	entries.clear();
+	for (uint32_t i = 0; i < proxies.size(); ++i)
+	{
+		const CellRange range(GetCellRange(proxies[i].Bounds));
+		if (GetCellCount(range) > MaxProxyCells)
+			continue;
+
+		for (int y = range.MinY; y <= range.MaxY; ++y)
+		{
+			for (int x = range.MinX; x <= range.MaxX; ++x)
+				entries.emplace_back(Entry { GetBucket(x, y), i });
+		}
+	}
+
+	//Counting sort by bucket.
+	bucketStarts.assign(bucketCount + 1, 0);
+	for (auto& e : entries)
+		++bucketStarts[e.Bucket + 1];
+	for (size_t b = 0; b < bucketCount; ++b)
+		bucketStarts[b + 1] += bucketStarts[b];
+
+	bucketIds.resize(entries.size());
+	for (auto& e : entries)
+		bucketIds[bucketStarts[e.Bucket]++] = e.Id;
+	//Filling moved every start to the next bucket, shift back.
+	for (size_t b = bucketCount; b > 0; --b)
+		bucketStarts[b] = bucketStarts[b - 1];
+	bucketStarts[0] = 0;
+
+	stamps.assign(proxies.size(), 0);
+	stamp = 0;
+
+	//Each pair is kept by its lower index only.
+	for (uint32_t i = 0; i < proxies.size(); ++i)
+	{
+		const BroadphaseProxy& a(proxies[i]);
+		ForEachNearby(a.Bounds, [this, i, &a](uint32_t j) {
+			if (j <= i)
+				return;
+
+			++stats.Candidates;
+			const BroadphaseProxy& b(proxies[j]);
+			if (WantsPair(a, b) && Overlaps(a.Bounds, b.Bounds))
+				pairs.emplace_back(BroadphasePair { i, j });
+		});
+	}
+	sort(pairs.begin(), pairs.end());
+
+	const chrono::duration<float, milli> elapsed(chrono::steady_clock::now() - start);
+	stats.Proxies = proxies.size();
+	stats.Cells = entries.size();
+	stats.Pairs = pairs.size();
+	stats.BuildMs = elapsed.count();
+}
+
+void SpatialHash::Query(const AABB& box, uint32_t mask, vector<uint32_t>& result)
+{
+	++stats.Queries;
+	if (proxies.empty())
+		return;
+
+	ForEachNearby(box, [this, &box, mask, &result](uint32_t id) {
+		++stats.Candidates;
+		if ((proxies[id].Layer & mask) != 0 && Overlaps(proxies[id].Bounds, box))
+			result.emplace_back(id);
+	});
+}
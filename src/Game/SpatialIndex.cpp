@@ -0,0 +1,117 @@
+#include "include/SpatialIndex.h"
+#include <algorithm>
+using namespace std;
+using namespace ComponentSystem;
+
+namespace
+{
+//Squared distance from 'point' to the closest point of 'box'.
+float GetDistanceSquared(const sf::Vector2f& point, const AABB& box) noexcept
+{
+	const float dx(max({ box.Left - point.x, 0.f, point.x - box.Right }));
+	const float dy(max({ box.Top - point.y, 0.f, point.y - box.Bottom }));
+	return dx * dx + dy * dy;
+}
+
+AABB GetBox(const sf::Vector2f& center, float radius) noexcept
+{
+	return AABB { center.x - radius, center.y - radius, center.x + radius, center.y + radius };
+}
+}
+
+void SpatialIndex::Clear(Broadphase* mBroadphase) noexcept
+{
+	broadphase = mBroadphase;
+	entries.clear();
+}
+
+void SpatialIndex::Add(EntityHandle entity, const AABB& bounds)
+{
+	entries.emplace_back(Entry { entity, bounds });
+}
+
+void SpatialIndex::SetObstacles(const AABBTree* mObstacles, const vector<EntityHandle>& entities, const vector<AABB>& bounds)
+{
+	obstacles = mObstacles;
+	obstacleEntries.clear();
+	for (size_t i = 0; i < entities.size(); ++i)
+		obstacleEntries.emplace_back(Entry { entities[i], bounds[i] });
+}
+
+size_t SpatialIndex::QueryAABB(const AABB& box, uint32_t groups, EntityHandle* result, size_t capacity)
+{
+	size_t found { 0 };
+	ForEachInBox(box, groups, [result, capacity, &found](EntityHandle mEntity, const AABB&) {
+		if (found < capacity)
+			result[found] = mEntity;
+		++found;
+	});
+	return found;
+}
+
+size_t SpatialIndex::QueryRadius(const sf::Vector2f& center, float radius, uint32_t groups, EntityHandle* result, size_t capacity)
+{
+	const float limit(radius * radius);
+	size_t found { 0 };
+	ForEachInBox(GetBox(center, radius), groups, [&center, limit, result, capacity, &found](EntityHandle mEntity, const AABB& mBounds) {
+		if (GetDistanceSquared(center, mBounds) > limit)
+			return;
+		if (found < capacity)
+			result[found] = mEntity;
+		++found;
+	});
+	return found;
+}
+
+size_t SpatialIndex::QueryKNearest(const sf::Vector2f& center, float maxRadius, uint32_t groups, EntityHandle* result, size_t k)
+{
+	if (k == 0 || maxRadius < 0.f)
+		return 0;
+
+	//Grow the search from about one cell until 'k' are in range,
+	//anything closer is then found too.
+	float radius(min(CollisionCellSize, maxRadius));
+	while (true)
+	{
+		const float limit(radius * radius);
+		candidates.clear();
+		ForEachInBox(GetBox(center, radius), groups, [this, &center, limit](EntityHandle mEntity, const AABB& mBounds) {
+			const float distance(GetDistanceSquared(center, mBounds));
+			if (distance <= limit)
+				candidates.emplace_back(Candidate { distance, mEntity });
+		});
+
+		if (candidates.size() >= k || radius >= maxRadius)
+			break;
+		radius = min(radius * 2.f, maxRadius);
+	}
+
+	//Ties go to the lower handle, so the order never depends on
+	//the broadphase.
+	const size_t count(min(k, candidates.size()));
+	partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [](const Candidate& a, const Candidate& b) {
+		return a.Distance < b.Distance || (a.Distance == b.Distance && a.Entity.Value < b.Entity.Value);
+	});
+	for (size_t i = 0; i < count; ++i)
+		result[i] = candidates[i].Entity;
+	return count;
+}
+
+bool SpatialIndex::Raycast(const sf::Vector2f& from, const sf::Vector2f& to, uint32_t groups, RayHit& hit)
+{
+	const AABB origin { from.x, from.y, from.x, from.y };
+	const AABB box { min(from.x, to.x), min(from.y, to.y), max(from.x, to.x), max(from.y, to.y) };
+	const float dx(to.x - from.x);
+	const float dy(to.y - from.y);
+
+	bool found { false };
+	ForEachInBox(box, groups, [&origin, dx, dy, &hit, &found](EntityHandle mEntity, const AABB& mBounds) {
+		float time { 0.f };
+		if (!SweepAABB(origin, dx, dy, mBounds, time))
+			return;
+		if (!found || time < hit.Time || (time == hit.Time && mEntity.Value < hit.Entity.Value))
+			hit = RayHit { mEntity, time };
+		found = true;
+	});
+	return found;
+}
@@ -0,0 +1,77 @@
+#include "include/SpriteBatch.h"
+#include "ComponentSystem/System.h"
+#include "include/Components.h"
+using namespace std;
+using namespace ComponentSystem;
+
+void SpriteBatch::Clear() noexcept
+{
+	for (auto& b : batches)
+		b.Quads.clear();
+	spriteCount = 0;
+}
+
+void SpriteBatch::Add(const sf::Sprite& sprite)
+{
+	const sf::Texture* texture(sprite.getTexture());
+	if (texture == nullptr)
+		return;
+
+	//A handful of textures, a linear search is enough.
+	auto it(find_if(batches.begin(), batches.end(), [texture](const Batch& mBatch) {
+		return mBatch.Texture == texture;
+	}));
+	if (it == batches.end())
+	{
+		batches.emplace_back(Batch { texture, sf::VertexArray(sf::Quads) });
+		it = batches.end() - 1;
+	}
+
+	const sf::Transform& transform(sprite.getTransform());
+	const sf::IntRect& rect(sprite.getTextureRect());
+	const sf::Color& color(sprite.getColor());
+	const float width(static_cast<float>(abs(rect.width)));
+	const float height(static_cast<float>(abs(rect.height)));
+	const float left(static_cast<float>(rect.left));
+	const float top(static_cast<float>(rect.top));
+	const float right(left + rect.width);
+	const float bottom(top + rect.height);
+
+	sf::VertexArray& quads(it->Quads);
+	quads.append(sf::Vertex(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+	quads.append(sf::Vertex(transform.transformPoint(width, 0.f), color, sf::Vector2f(right, top)));
+	quads.append(sf::Vertex(transform.transformPoint(width, height), color, sf::Vector2f(right, bottom)));
+	quads.append(sf::Vertex(transform.transformPoint(0.f, height), color, sf::Vector2f(left, bottom)));
+	++spriteCount;
+}
+
+void SpriteBatch::AddSprites(EntityManager& manager)
+{
+	ForEachComponent<CSprite2D>(manager, [this](CSprite2D& mSprite) {
+		if (mSprite.Visable)
+			Add(mSprite.GetSprite());
+	});
+}
+
+const sf::VertexArray* SpriteBatch::GetQuads(const sf::Texture* texture) const noexcept
+{
+	for (auto& b : batches)
+	{
+		if (b.Texture == texture)
+			return &b.Quads;
+	}
+	return nullptr;
+}
+
+void SpriteBatch::Draw(sf::RenderTarget& target)
+{
+	drawCalls = 0;
+	for (auto& b : batches)
+	{
+		if (b.Quads.getVertexCount() == 0)
+			continue;
+
+		target.draw(b.Quads, sf::RenderStates(b.Texture));
+		++drawCalls;
+	}
+}
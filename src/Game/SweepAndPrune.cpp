@@ -0,0 +1,143 @@
+#include "include/SweepAndPrune.h"
+#include <algorithm>
+#include <chrono>
+using namespace std;
+
+bool SweepAndPrune::IsBefore(const Endpoint& a, const Endpoint& b) noexcept
+{
+	//Left edges go first on a tie so touching boxes overlap.
+	return a.Value < b.Value || (a.Value == b.Value && !a.IsMax() && b.IsMax());
+}
+
+void SweepAndPrune::SyncEndpoints()
+{
+	const auto count(static_cast<uint32_t>(proxies.size()));
+
+	//Forget proxies that are gone, keep the order of the rest.
+	endpoints.erase(remove_if(endpoints.begin(), endpoints.end(), [count](const Endpoint& mEndpoint) {
+		return mEndpoint.Id() >= count;
+	}),
+		endpoints.end());
+	const auto known(static_cast<uint32_t>(endpoints.size() / 2));
+
+	maxWidth = 0.f;
+	for (auto& e : endpoints)
+	{
+		const AABB& bounds(proxies[e.Id()].Bounds);
+		e.Value = e.IsMax() ? bounds.Right : bounds.Left;
+		maxWidth = max(maxWidth, bounds.Right - bounds.Left);
+	}
+
+	//New proxies are appended, the sort moves them in place.
+	for (uint32_t i = known; i < count; ++i)
+	{
+		const AABB& bounds(proxies[i].Bounds);
+		endpoints.emplace_back(Endpoint { bounds.Left, i << 1 });
+		endpoints.emplace_back(Endpoint { bounds.Right, (i << 1) | 1u });
+		maxWidth = max(maxWidth, bounds.Right - bounds.Left);
+	}
+}
+
+void SweepAndPrune::SortEndpoints()
+{
+	//Close to sorted already, so insertion sort is about linear.
+	for (size_t i = 1; i < endpoints.size(); ++i)
+	{
+		const Endpoint key(endpoints[i]);
+		size_t j(i);
+		while (j > 0 && IsBefore(key, endpoints[j - 1]))
+		{
+			endpoints[j] = endpoints[j - 1];
+			--j;
+		}
+		stats.Cells += i - j;
+		endpoints[j] = key;
+	}
+}
+
+void SweepAndPrune::Sweep()
+{
+	active.clear();
+	activeBounds.Clear();
+	activePositions.resize(proxies.size());
+
+	for (auto& e : endpoints)
+	{
+		const uint32_t id(e.Id());
+		if (e.IsMax())
+		{
+			//Swap out of the active list.
+			const uint32_t position(activePositions[id]);
+			active[position] = active.back();
+			activePositions[active[position]] = position;
+			active.pop_back();
+			activeBounds.SwapRemove(position);
+			continue;
+		}
+
+		//Everything active overlaps this one on X. A crowd is
+		//tested in one batch, a few are not worth the setup.
+		const BroadphaseProxy& a(proxies[id]);
+		stats.Candidates += active.size();
+		if (active.size() >= MinBatchSize)
+		{
+			OverlapBatch(a.Bounds, activeBounds, hits);
+			util::ForEachHit(hits, [this, id, &a](size_t k) {
+				const uint32_t other(active[k]);
+				if (WantsPair(a, proxies[other]))
+					pairs.emplace_back(id < other ? BroadphasePair { id, other } : BroadphasePair { other, id });
+			});
+		}
+		else
+		{
+			for (auto& other : active)
+			{
+				const BroadphaseProxy& b(proxies[other]);
+				if (WantsPair(a, b) && a.Bounds.Bottom >= b.Bounds.Top && a.Bounds.Top <= b.Bounds.Bottom)
+					pairs.emplace_back(id < other ? BroadphasePair { id, other } : BroadphasePair { other, id });
+			}
+		}
+
+		activePositions[id] = static_cast<uint32_t>(active.size());
+		active.emplace_back(id);
+		activeBounds.Add(a.Bounds);
+	}
+}
+
+void SweepAndPrune::Update(const vector<BroadphaseProxy>& mProxies)
+{
+	const auto start(chrono::steady_clock::now());
+	stats = BroadphaseStats {};
+	pairs.clear();
+
+	proxies = mProxies;
+	SyncEndpoints();
+	SortEndpoints();
+	Sweep();
+	sort(pairs.begin(), pairs.end());
+
+	const chrono::duration<float, milli> elapsed(chrono::steady_clock::now() - start);
+	stats.Proxies = proxies.size();
+	stats.Pairs = pairs.size();
+	stats.BuildMs = elapsed.count();
+}
+
+void SweepAndPrune::Query(const AABB& box, uint32_t mask, vector<uint32_t>& result)
+{
+	++stats.Queries;
+
+	//No proxy is wider than 'maxWidth', so none starting left
+	//of 'box.Left - maxWidth' can reach the box.
+	const Endpoint first { box.Left - maxWidth, 0u };
+	auto it(lower_bound(endpoints.begin(), endpoints.end(), first, IsBefore));
+	for (; it != endpoints.end() && it->Value <= box.Right; ++it)
+	{
+		if (it->IsMax())
+			continue;
+
+		++stats.Candidates;
+		const BroadphaseProxy& p(proxies[it->Id()]);
+		if ((p.Layer & mask) != 0 && Overlaps(p.Bounds, box))
+			result.emplace_back(it->Id());
+	}
+}
@@ -0,0 +1,112 @@
+#include "include/TextureAtlas.h"
+#include "ComponentSystem/Snapshot.h"
+#include <numeric>
+using namespace std;
+using namespace ComponentSystem;
+
+bool AtlasManifest::Save(const string& path) const
+{
+	SnapshotWriter writer;
+	writer.Write(AtlasMagic);
+	writer.Write(AtlasVersion);
+	writer.Write(static_cast<uint32_t>(Pages.size()));
+	writer.Write(static_cast<uint32_t>(Regions.size()));
+	for (auto& page : Pages)
+		writer.WriteString(page);
+	for (size_t i = 0; i < Regions.size(); ++i)
+	{
+		writer.WriteString(Names[i]);
+		writer.Write(Regions[i]);
+	}
+	return writer.SaveToFile(path);
+}
+
+bool AtlasManifest::Load(const string& path)
+{
+	Pages.clear();
+	Names.clear();
+	Regions.clear();
+
+	//No manifest is fine, the game uses the loose files.
+	ifstream file(path, ios::binary | ios::ate);
+	if (!file)
+		return false;
+	vector<char> buffer(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(buffer.data(), static_cast<streamsize>(buffer.size()));
+
+	SnapshotReader reader(buffer);
+	if (reader.Read<uint32_t>() != AtlasMagic || reader.Read<uint32_t>() != AtlasVersion)
+	{
+		cout << "Error! Atlas format not supported!" << endl;
+		return false;
+	}
+
+	const auto pageCount(reader.Read<uint32_t>());
+	const auto regionCount(reader.Read<uint32_t>());
+	for (uint32_t i = 0; i < pageCount && reader.IsValid(); ++i)
+		Pages.emplace_back(reader.ReadString());
+	bool broken { false };
+	for (uint32_t i = 0; i < regionCount && reader.IsValid(); ++i)
+	{
+		Names.emplace_back(reader.ReadString());
+		Regions.emplace_back(reader.Read<AtlasRegion>());
+		broken = broken || Regions.back().Page >= Pages.size();
+	}
+
+	if (broken || !reader.IsValid())
+	{
+		cout << "Error! Atlas " << path << " is broken!" << endl;
+		Pages.clear();
+		Names.clear();
+		Regions.clear();
+		return false;
+	}
+	return true;
+}
+
+size_t PackAtlas(const vector<sf::Vector2u>& sizes, unsigned pageSize, unsigned padding, vector<AtlasRegion>& regions)
+{
+	regions.assign(sizes.size(), AtlasRegion {});
+
+	//Tallest first, so each row wastes little above its
+	//shorter images. Ties keep the given order.
+	vector<size_t> order(sizes.size());
+	iota(order.begin(), order.end(), size_t { 0 });
+	stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) {
+		return sizes[a].y > sizes[b].y || (sizes[a].y == sizes[b].y && sizes[a].x > sizes[b].x);
+	});
+
+	size_t page { 0 };
+	unsigned x { padding };
+	unsigned y { padding };
+	unsigned rowHeight { 0 };
+	for (auto i : order)
+	{
+		const unsigned width(sizes[i].x);
+		const unsigned height(sizes[i].y);
+		if (width + 2 * padding > pageSize || height + 2 * padding > pageSize)
+			return 0;
+
+		//Next row, then next page.
+		if (x + width + padding > pageSize)
+		{
+			x = padding;
+			y += rowHeight + padding;
+			rowHeight = 0;
+		}
+		if (y + height + padding > pageSize)
+		{
+			++page;
+			x = padding;
+			y = padding;
+			rowHeight = 0;
+		}
+
+		regions[i] = AtlasRegion { static_cast<uint16_t>(page), static_cast<uint16_t>(x), static_cast<uint16_t>(y),
+			static_cast<uint16_t>(width), static_cast<uint16_t>(height) };
+		x += width + padding;
+		rowHeight = max(rowHeight, height);
+	}
+	return sizes.empty() ? 0 : page + 1;
+}
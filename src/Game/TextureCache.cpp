@@ -0,0 +1,71 @@
+#include "include/TextureCache.h"
+#include "include/TextureAtlas.h"
+using namespace std;
+
+shared_ptr<const sf::Texture> TextureCache::Get(const string& path)
+{
+	auto it(textures.find(path));
+	if (it != textures.end())
+		return it->second;
+
+	auto texture(make_shared<sf::Texture>());
+	if (!texture->loadFromFile(path))
+	{
+		cout << "Error! Texture " << path << " not found!" << endl;
+		texture.reset();
+	}
+	textures.emplace(path, texture);
+	return texture;
+}
+
+bool TextureCache::LoadAtlas(const string& manifestPath)
+{
+	AtlasManifest manifest;
+	if (!manifest.Load(manifestPath))
+		return false;
+
+	const string folder(manifestPath.substr(0, manifestPath.find_last_of('/') + 1));
+	vector<shared_ptr<const sf::Texture>> pages;
+	for (auto& page : manifest.Pages)
+	{
+		pages.emplace_back(Get(folder + page));
+		if (pages.back() == nullptr)
+			return false;
+	}
+
+	regions.clear();
+	for (size_t i = 0; i < manifest.Regions.size(); ++i)
+	{
+		const AtlasRegion& r(manifest.Regions[i]);
+		regions[manifest.Names[i]] = TextureRegion { pages[r.Page], sf::IntRect(r.Left, r.Top, r.Width, r.Height) };
+	}
+	return true;
+}
+
+TextureRegion TextureCache::GetRegion(const string& path)
+{
+	auto it(regions.find(path));
+	if (it != regions.end())
+		return it->second;
+
+	TextureRegion region { Get(path), sf::IntRect() };
+	if (region.Texture != nullptr)
+		region.Rect = sf::IntRect(0, 0, static_cast<int>(region.Texture->getSize().x), static_cast<int>(region.Texture->getSize().y));
+	return region;
+}
+
+size_t TextureCache::Prune()
+{
+	size_t dropped { 0 };
+	for (auto it(textures.begin()); it != textures.end();)
+	{
+		if (it->second != nullptr && it->second.use_count() == 1)
+		{
+			it = textures.erase(it);
+			++dropped;
+		}
+		else
+			++it;
+	}
+	return dropped;
+}
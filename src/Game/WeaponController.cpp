@@ -3,13 +3,13 @@ using namespace std;
 using namespace ComponentSystem;
 
 WeaponController::WeaponController(const WeaponType mType, EntityFactory& mFactory, ComponentSystem::EntityManager& mManager,
-	eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& mDispatcher, sf::RenderWindow& mWindow, sf::Vector2f& mPos) :
+	eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& mDispatcher, sf::RenderWindow& mWindow, ComponentSystem::EntityHandle mOwner) :
 	Type(mType),
 	factory(mFactory),
 	manager(mManager),
 	gameDispatcher(mDispatcher),
 	window(mWindow),
-	weaponMountPoint(mPos)
+	owner(mOwner)
 {
 	Init();
 }
@@ -28,6 +28,11 @@ void WeaponController::Init()
 	});
 }
 
+void WeaponController::SetOwner(EntityHandle mOwner)
+{
+	owner = mOwner;
+}
+
 void WeaponController::Update(float mFT)
 {
 	if (FireWaitTimer > 0)
@@ -73,6 +78,11 @@ void WeaponController::Attack()
 
 void WeaponController::GunAttack()
 {
+	GameEntity* o(manager.TryGetEntity(owner));
+	if (o == nullptr)
+		return;
+	const sf::Vector2f weaponMountPoint(o->GetComponent<CTransform>().Position);
+
 	gameDispatcher.dispatch(MyEvent { EventNames::SoundEvent, ShootSoundPath, 0 });
 
 	sf::Vector2f mousePos = sf::Vector2f(sf::Mouse::getPosition(window));
@@ -86,7 +96,7 @@ void WeaponController::GunAttack()
 		direction = directionNormalized;
 	}
 	float speedTemp(0.5f);
-	factory.CreateProjectile(weaponMountPoint, direction, window, speedTemp, 1);
+	factory.QueueProjectile(weaponMountPoint, direction, window, speedTemp, 1);
 }
 
 void WeaponController::KnifeAttack()
@@ -0,0 +1,61 @@
+#pragma once
+#include "Broadphase.h"
+#include "Utility/BitMask.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines the batched box overlap test.
+///
+///One box is tested against many candidates at
+///once. Candidates are stored edge by edge, so four
+///(SSE) or eight (AVX2) of them are loaded and
+///compared together, and the result is a bitmask
+///with one bit per candidate.
+///
+///The fastest kernel the CPU runs is picked the
+///first time one is needed, with a scalar one for
+///CPUs and targets without SSE.
+///
+/////////////////////////////////////////////////
+
+//Boxes split into one array per edge.
+struct AABBBatch
+{
+	std::vector<float> Left;
+	std::vector<float> Top;
+	std::vector<float> Right;
+	std::vector<float> Bottom;
+
+	std::size_t Size() const noexcept
+	{
+		return Left.size();
+	}
+
+	void Clear() noexcept;
+	void Add(const AABB& box);
+	//Moves the last box into 'index', like the lists using it.
+	void SwapRemove(std::size_t index) noexcept;
+};
+
+enum class AABBKernelType
+{
+	Scalar,
+	SSE,
+	AVX2
+};
+
+//Sets bit 'i % 64' of 'hits[i / 64]' when 'box' overlaps
+//candidate 'i', touching counts. Every word is written.
+using AABBKernel = void (*)(const AABB& box, const AABBBatch& batch, std::uint64_t* hits);
+
+//Null when this build or this CPU can not run 'type'.
+AABBKernel GetAABBKernel(AABBKernelType type) noexcept;
+//The fastest kernel this CPU runs.
+AABBKernelType GetBestAABBKernelType() noexcept;
+const char* GetAABBKernelName(AABBKernelType type) noexcept;
+
+//Tests 'box' against all of 'batch' with the fastest kernel.
+void OverlapBatch(const AABB& box, const AABBBatch& batch, std::vector<std::uint64_t>& hits);
@@ -0,0 +1,111 @@
+#pragma once
+#include "Broadphase.h"
+#include <cstdint>
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines AABBTree, a bounding volume
+///hierarchy over boxes that do not move.
+///
+///The tree is built once, top down: each node is
+///split at the median of the longest axis until a
+///few boxes are left. Nodes sit in one array, the
+///left child right after its parent, so a query
+///walks memory mostly forward.
+///
+///Build it again when boxes are added or removed,
+///there is no refit.
+///
+/////////////////////////////////////////////////
+class AABBTree
+{
+public:
+	struct RayHit
+	{
+		std::uint32_t Id;
+		float Time; //Along the ray, 0 at the origin and 1 at the end.
+	};
+
+private:
+	//A leaf holds 'Count' boxes from 'First', a branch has no
+	//boxes and its right child at 'First'.
+	struct Node
+	{
+		AABB Bounds;
+		std::uint32_t First;
+		std::uint32_t Count;
+	};
+
+	struct Item
+	{
+		AABB Box;
+		std::uint32_t Id;
+	};
+
+	static constexpr std::uint32_t LeafSize { 4 };
+	//Deep enough for any tree of median splits.
+	static constexpr std::size_t MaxDepth { 64 };
+
+	std::vector<Node> nodes;
+	std::vector<Item> items;
+
+	std::uint32_t BuildNode(std::uint32_t first, std::uint32_t count);
+	//Walks every node 'mEnter(bounds)' accepts and calls 'mVisit(item)'
+	//on the items of its leaves, until 'mVisit' returns true.
+	template <typename Enter, typename Visit>
+	void Traverse(Enter&& mEnter, Visit&& mVisit) const;
+
+public:
+	//Box 'i' is known by id 'i'.
+	void Build(const std::vector<AABB>& boxes);
+	void Clear() noexcept;
+
+	std::size_t Size() const noexcept
+	{
+		return items.size();
+	}
+	std::size_t GetNodeCount() const noexcept
+	{
+		return nodes.size();
+	}
+
+	//Append the id of every box overlapping 'box', touching counts.
+	void Query(const AABB& box, std::vector<std::uint32_t>& result) const;
+	//True when any box overlaps 'box', stops at the first.
+	bool Overlaps(const AABB& box) const;
+	//Closest box the segment from ('x', 'y') to ('x + dx', 'y + dy')
+	//touches, false if none.
+	bool Raycast(float x, float y, float dx, float dy, RayHit& hit) const;
+};
+
+template <typename Enter, typename Visit>
+void AABBTree::Traverse(Enter&& mEnter, Visit&& mVisit) const
+{
+	if (nodes.empty())
+		return;
+
+	std::uint32_t stack[MaxDepth];
+	std::size_t top { 0 };
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const std::uint32_t index(stack[--top]);
+		const Node& node(nodes[index]);
+		if (!mEnter(node.Bounds))
+			continue;
+
+		if (node.Count == 0)
+		{
+			stack[top++] = node.First;
+			stack[top++] = index + 1;
+			continue;
+		}
+
+		for (std::uint32_t i = node.First; i < node.First + node.Count; ++i)
+		{
+			if (mVisit(items[i]))
+				return;
+		}
+	}
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines the base of the collision
+///broadphases.
+///
+///Every collider is handed over as a proxy once per
+///step. The broadphase finds the pairs whose boxes
+///overlap and whose layers care about each other,
+///so the CollisionManager only tests those instead
+///of every pair.
+///
+///Broadphases are picked at runtime, see
+///'CollisionManager::SetBroadphase'.
+///
+/////////////////////////////////////////////////
+
+//Axis aligned box, same edges as CPhysics.
+struct AABB
+{
+	float Left;
+	float Top;
+	float Right;
+	float Bottom;
+};
+
+//Touching counts, like the batched kernels in 'AABBKernel.h'.
+inline bool Overlaps(const AABB& a, const AABB& b) noexcept
+{
+	return a.Right >= b.Left && a.Left <= b.Right && a.Bottom >= b.Top && a.Top <= b.Bottom;
+}
+
+//Moves 'box' by ('dx', 'dy') and finds the first time in [0, 1]
+//it touches 'target', written to 'mTime'. False if it never does.
+inline bool SweepAABB(const AABB& box, float dx, float dy, const AABB& target, float& mTime) noexcept
+{
+	float enter { 0.f };
+	float exit { 1.f };
+
+	//Narrows [enter, exit] to when the boxes overlap on one axis.
+	const auto clip = [&enter, &exit](float minA, float maxA, float minB, float maxB, float delta) {
+		if (delta == 0.f)
+			return maxA >= minB && minA <= maxB;
+
+		float first((minB - maxA) / delta);
+		float last((maxB - minA) / delta);
+		if (first > last)
+			std::swap(first, last);
+		enter = std::max(enter, first);
+		exit = std::min(exit, last);
+		return enter <= exit;
+	};
+
+	if (!clip(box.Left, box.Right, target.Left, target.Right, dx) || !clip(box.Top, box.Bottom, target.Top, target.Bottom, dy))
+		return false;
+
+	mTime = enter;
+	return true;
+}
+
+struct BroadphaseProxy
+{
+	AABB Bounds;
+	std::uint32_t Layer; //Single bit the proxy is on.
+	std::uint32_t Mask;  //Layers it collides with.
+};
+
+//Either side asking for the other is enough.
+inline bool WantsPair(const BroadphaseProxy& a, const BroadphaseProxy& b) noexcept
+{
+	return (a.Mask & b.Layer) != 0 || (b.Mask & a.Layer) != 0;
+}
+
+//Indices of two proxies, always 'A < B'.
+struct BroadphasePair
+{
+	std::uint32_t A;
+	std::uint32_t B;
+};
+
+inline bool operator==(const BroadphasePair& a, const BroadphasePair& b) noexcept
+{
+	return a.A == b.A && a.B == b.B;
+}
+
+inline bool operator<(const BroadphasePair& a, const BroadphasePair& b) noexcept
+{
+	return a.A < b.A || (a.A == b.A && a.B < b.B);
+}
+
+enum class BroadphaseType
+{
+	SpatialHash,
+	SweepAndPrune
+};
+
+//What the last Update and the queries since did.
+struct BroadphaseStats
+{
+	std::size_t Proxies { 0 };    //Proxies in the last Update.
+	std::size_t Cells { 0 };      //Proxy/cell entries, or endpoint swaps for sweep and prune.
+	std::size_t Queries { 0 };    //Queries since the last Update.
+	std::size_t Candidates { 0 }; //Proxies looked at, by the Update and the queries.
+	std::size_t Pairs { 0 };      //Overlapping pairs found by the Update.
+	float BuildMs { 0.f };        //Time of the last Update.
+};
+
+class Broadphase
+{
+protected:
+	BroadphaseStats stats;
+	std::vector<BroadphasePair> pairs;
+
+public:
+	virtual ~Broadphase() = default;
+
+	virtual const char* GetName() const noexcept = 0;
+
+	//Take this step's proxies, a proxy is known by its index
+	//in 'proxies'. Keep indices stable between steps when
+	//possible, some broadphases reuse the last step's work.
+	virtual void Update(const std::vector<BroadphaseProxy>& proxies) = 0;
+
+	//Append the index of every proxy on a layer of 'mask'
+	//overlapping 'box' to 'result', each at most once.
+	virtual void Query(const AABB& box, std::uint32_t mask, std::vector<std::uint32_t>& result) = 0;
+
+	//Pairs found by the last Update, sorted.
+	const std::vector<BroadphasePair>& GetPairs() const noexcept
+	{
+		return pairs;
+	}
+
+	const BroadphaseStats& GetStats() const noexcept
+	{
+		return stats;
+	}
+};
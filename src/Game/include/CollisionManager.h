@@ -1,28 +1,168 @@
 #pragma once
 #include "ComponentSystem/EntityManager.h"
+#include "AABBTree.h"
+#include "CollisionMatrix.h"
 #include "Components.h"
+#include "ContactCache.h"
 #include "GlobalGameSettings.h"
+#include "SpatialHash.h"
+#include "SpatialIndex.h"
+#include "SweepAndPrune.h"
+#include <functional>
+#include <memory>
 #include "eventpp/eventdispatcher.h"
 
+//'a' is in the first group the response was registered with.
+using CollisionCallback = std::function<void(ComponentSystem::GameEntity& a, ComponentSystem::GameEntity& b)>;
+//Either one may be gone by the time the contact ends.
+using CollisionExitCallback = std::function<void(ComponentSystem::GameEntity* a, ComponentSystem::GameEntity* b)>;
+
+//What two groups do about touching, any callback can be left empty.
+struct CollisionResponse
+{
+	CollisionCallback OnEnter; //First step they touch.
+	CollisionCallback OnStay;  //Every step after, while they touch.
+	CollisionExitCallback OnExit;
+};
+
 class CollisionManager
 {
 private:
+	struct Collider
+	{
+		ComponentSystem::GameEntity* Entity;
+		ComponentSystem::CPhysics* Physics;
+		std::uint32_t Group;
+	};
+
+	//Registered as (a, b), both entries point at it. The pair
+	//is flipped when found as (b, a).
+	struct ResponseEntry
+	{
+		std::uint32_t Response { NoResponse };
+		bool Swapped { false };
+	};
+	static constexpr std::uint32_t NoResponse { ~0u };
+
 	ComponentSystem::EntityManager& manager;
 	eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& gameDispatcher;
 
-	template <class T1, class T2>
-	bool IsIntersecting(T1& mA, T2& mB) noexcept;
+	CollisionMatrix matrix;
+	std::array<std::array<ResponseEntry, CollisionGroupCount>, CollisionGroupCount> responseTable;
+	//Indexed by 'groupA * CollisionGroupCount + groupB'.
+	std::array<CollisionResponse, CollisionGroupCount * CollisionGroupCount> responses;
+	ContactCache contacts;
+
+	//One per proxy and in the same order, grouped by 'EntityGroup'.
+	//Players, then enemies, ... then projectiles, so the ones that
+	//come and go most are last and the indices of the others barely
+	//change between steps. Kept around so the capacity is reused.
+	std::vector<Collider> colliders;
+
+	//Obstacles never move, so they are kept out of the broadphase
+	//in a tree built again only when the Obstacle group changes.
+	//Colliders of 'blockedGroups' are pushed out of them.
+	AABBTree obstacles;
+	std::vector<ComponentSystem::EntityHandle> obstacleHandles;
+	std::vector<ComponentSystem::EntityHandle> obstacleEntities; //Same order as 'obstacleBounds'.
+	std::vector<AABB> obstacleBounds;
+	std::vector<std::uint32_t> blockers;
+	std::uint32_t blockedGroups { (1u << EntityGroup::Player) | (1u << EntityGroup::Enemy) };
+
+	std::unique_ptr<Broadphase> broadphase;
+	BroadphaseType broadphaseType { BroadphaseType::SpatialHash };
+	float cellSize { CollisionCellSize };
+	std::vector<BroadphaseProxy> proxies;
+	SpatialIndex spatialIndex;
+
+	//Pairs are detected in slices on the thread pool, each slice
+	//into its own buffer. Buffers are resolved in slice order,
+	//which is pair order, so responses run the same way whatever
+	//the thread count.
+	static constexpr std::size_t PairsPerSlice { 1024 };
+	std::vector<std::vector<Contact>> contactBuffers;
+	std::size_t contactSlices { 0 };
+
+	void CollectColliders();
+	static AABB GetBounds(const ComponentSystem::CPhysics& physics) noexcept;
+	static AABB GetLastStepBounds(const ComponentSystem::CPhysics& physics) noexcept;
+	//Continuous colliders get a proxy over their last step.
+	static BroadphaseProxy MakeProxy(const ComponentSystem::CPhysics& physics, std::uint32_t layer, std::uint32_t mask) noexcept;
+	//Narrowphase of a broadphase pair, only continuous colliders
+	//need one: a swept test of their last step.
+	static bool IsTouching(const ComponentSystem::CPhysics& a, const ComponentSystem::CPhysics& b) noexcept;
+	void PushOutOfObstacles(ComponentSystem::GameEntity& entity, const ComponentSystem::CPhysics& physics);
+
+	//The game's own responses.
+	void SetDefaultResponses();
+	static void HitPlayer(ComponentSystem::GameEntity& enemy, ComponentSystem::GameEntity& player);
+	static void HitEnemy(ComponentSystem::GameEntity& projectile, ComponentSystem::GameEntity& enemy);
+	void ReleaseEnemy(ComponentSystem::GameEntity* enemy) const;
+
+	//Pairs come from the broadphase, which already tested the
+	//boxes with the batched kernel, see 'AABBKernel.h'. Detect
+	//only reads, so it is safe on many threads. Resolve updates
+	//the contacts and calls the responses, on one thread.
+	void DetectContacts();
+	void DetectContacts(std::size_t slice);
+	void ResolveContacts();
+
 	bool stop { false };
 
 public:
 	CollisionManager(ComponentSystem::EntityManager& mManager, eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& dispatcher);
 
 	void TestAllCollision();
-	void TestCollision(ComponentSystem::GameEntity& a, ComponentSystem::GameEntity& b) noexcept;
-};
 
-template <class T1, class T2>
-bool CollisionManager::IsIntersecting(T1& mA, T2& mB) noexcept
-{
-	return mA.Right() >= mB.Left() && mA.Left() <= mB.Right() && mA.Bottom() >= mB.Top() && mA.Top() <= mB.Bottom();
-}
+	//Make 'a' and 'b' collide and call 'response(a, b)' on every
+	//touching pair, replacing what (a, b) or (b, a) had.
+	void SetResponse(EntityGroup a, EntityGroup b, CollisionResponse response);
+	//Stop 'a' and 'b' from colliding.
+	void ClearResponse(EntityGroup a, EntityGroup b);
+	//Forget the contacts, call it when the world is rebuilt.
+	void ClearContacts() noexcept
+	{
+		contacts.Clear();
+	}
+	const ContactCache& GetContacts() const noexcept
+	{
+		return contacts;
+	}
+
+	//Build the obstacle tree again if obstacles were added or
+	//removed, every test does it first.
+	void RefreshObstacles();
+	const AABBTree& GetObstacles() const noexcept
+	{
+		return obstacles;
+	}
+	//Queries on the colliders of the last test.
+	SpatialIndex& GetSpatialIndex() noexcept
+	{
+		return spatialIndex;
+	}
+	//False when an obstacle is in the way from 'from' to 'to'.
+	bool HasLineOfSight(const sf::Vector2f& from, const sf::Vector2f& to) const;
+	//Players and enemies are blocked by default.
+	void SetBlockedByObstacles(EntityGroup group, bool blocked) noexcept;
+	const CollisionMatrix& GetMatrix() const noexcept
+	{
+		return matrix;
+	}
+
+	//Switch broadphase, takes effect on the next test.
+	void SetBroadphase(BroadphaseType type);
+	BroadphaseType GetBroadphaseType() const noexcept
+	{
+		return broadphaseType;
+	}
+	const Broadphase& GetBroadphase() const noexcept
+	{
+		return *broadphase;
+	}
+
+	//Tune the cell size against the arena and enemy sizes,
+	//only used by the spatial hash.
+	void SetCellSize(float size);
+	const BroadphaseStats& GetBroadphaseStats() const noexcept;
+};
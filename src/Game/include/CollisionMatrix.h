@@ -0,0 +1,55 @@
+#pragma once
+#include "GlobalGameSettings.h"
+#include <array>
+#include <cstdint>
+
+/////////////////////////////////////////////////
+///
+///This file defines CollisionMatrix, which groups
+///collide with which.
+///
+///Each group has a mask of the groups it collides
+///with. The masks are what the broadphase proxies
+///carry, so pairs of groups that do not collide are
+///dropped before any narrowphase work.
+///
+///The matrix is symmetric, setting (a, b) also sets
+///(b, a).
+///
+/////////////////////////////////////////////////
+
+//Enough for every 'EntityGroup', masks are 32 bits.
+constexpr std::size_t CollisionGroupCount { 8 };
+static_assert(EntityGroup::Consumable < CollisionGroupCount, "Add room for the new groups.");
+
+class CollisionMatrix
+{
+private:
+	std::array<std::uint32_t, CollisionGroupCount> masks {};
+
+public:
+	void SetCollides(std::size_t a, std::size_t b, bool collides) noexcept
+	{
+		if (collides)
+		{
+			masks[a] |= 1u << b;
+			masks[b] |= 1u << a;
+		}
+		else
+		{
+			masks[a] &= ~(1u << b);
+			masks[b] &= ~(1u << a);
+		}
+	}
+
+	bool Collides(std::size_t a, std::size_t b) const noexcept
+	{
+		return ((masks[a] >> b) & 1u) != 0;
+	}
+
+	//Groups colliding with 'group', one bit each.
+	std::uint32_t GetMask(std::size_t group) const noexcept
+	{
+		return masks[group];
+	}
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include "ComponentSystem/EntityManager.h"
 #include "GlobalGameSettings.h"
+#include "ParticlePool.h"
+#include "TextureCache.h"
 #include "eventpp/eventdispatcher.h"
 
 /////////////////////////////////////////////////
@@ -27,6 +29,15 @@ struct CCounter : Component
 	{
 		Counter += mFT;
 	}
+
+	void Save(SnapshotWriter& writer) const override
+	{
+		writer.Write(Counter);
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		reader.Read(Counter);
+	}
 };
 
 /*
@@ -55,6 +66,19 @@ struct CTransform : Component
 		Size(1.f, 1.f),
 		Rotation(0.f)
 	{}
+
+	void Save(SnapshotWriter& writer) const override
+	{
+		writer.Write(Position);
+		writer.Write(Size);
+		writer.Write(Rotation);
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		reader.Read(Position);
+		reader.Read(Size);
+		reader.Read(Rotation);
+	}
 };
 
 /*
@@ -72,18 +96,19 @@ struct CSprite2D : Component
 private:
 	sf::RenderWindow& target;
 	CTransform* transform { nullptr };
-	sf::Texture texture;
+	std::shared_ptr<const sf::Texture> texture; //Shared with every sprite of the same file or atlas page.
 	sf::Sprite sprite;
+	std::string texturePath;
 
 public:
 	bool Visable { true };
 	sf::Vector2f Origin;
 
 	CSprite2D() = default;
-	CSprite2D(std::string filePath, sf::RenderWindow& window) :
+	CSprite2D(TextureCache& textures, std::string filePath, sf::RenderWindow& window) :
 		target(window)
 	{
-		SetTexture(filePath);
+		SetTexture(textures.GetRegion(filePath), filePath);
 	}
 
 	void Init() override
@@ -113,20 +138,45 @@ public:
 		sprite.setColor(color);
 	}
 
-	bool SetTexture(std::string filepath)
+	//The texture path comes first, the loader reads it
+	//to construct the sprite before 'Load' is called.
+	void Save(SnapshotWriter& writer) const override
 	{
-		if (!texture.loadFromFile(filepath))
-		{
-			std::cout << "Error! Player texture not found!" << std::endl;
+		writer.WriteString(texturePath);
+		writer.Write(Visable);
+		writer.Write(Origin);
+		writer.Write(sprite.getColor());
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		reader.Read(Visable);
+		reader.Read(Origin);
+		sprite.setColor(reader.Read<sf::Color>());
+	}
+
+	const sf::Sprite& GetSprite() const noexcept
+	{
+		return sprite;
+	}
+	const std::string& GetTexturePath() const noexcept
+	{
+		return texturePath;
+	}
+
+	//'mRegion' is the whole texture of a loose file, or the part
+	//of an atlas page the file was packed to.
+	bool SetTexture(TextureRegion mRegion, std::string filepath)
+	{
+		texturePath = filepath;
+		texture = std::move(mRegion.Texture);
+		if (texture == nullptr)
 			return false;
-		}
-		else
-		{
-			sprite.setTexture(texture);
-			sprite.scale(sf::Vector2f(1.f, 1.f));
-			sprite.setOrigin(sf::Vector2f(sprite.getTexture()->getSize().x * 0.5f, sprite.getTexture()->getSize().y * 0.5f));
-			return true;
-		}
+
+		sprite.setTexture(*texture);
+		sprite.setTextureRect(mRegion.Rect);
+		sprite.scale(sf::Vector2f(1.f, 1.f));
+		sprite.setOrigin(sf::Vector2f(mRegion.Rect.width * 0.5f, mRegion.Rect.height * 0.5f));
+		return true;
 	}
 };
 
@@ -136,252 +186,87 @@ public:
  * This Component is a particle emitter.
  *
  * Entity with this component can emit particles.
+ * The particles live in the ParticlePool, this
+ * only keeps the settings of its bursts there.
  */
-struct Particle
-{
-	sf::Vector2f pos; // Position
-	sf::Vector2f vel; // Velocity
-	sf::Color color;  // RGBA
-};
-enum Shape
-{
-	CIRCLE,
-	SQUARE
-};
 struct CParticle : Component
 {
 private:
-	sf::Vector2f position; // Particle origin (pixel co-ordinates)
-	sf::Vector2f gravity;  // Affects particle velocities
-	sf::Color transparent; // sf::Color( 0, 0, 0, 0 )
-	sf::Image* image;
-	sf::Texture texture;
-	sf::Sprite sprite; // Connected to Texture
-	sf::Color color;
-	float particleSpeed { 1.f };
-	bool dissolve { false }; // Dissolution enabled?
-	unsigned char dissolutionRate { 4 };
-	unsigned char shape { Shape::SQUARE };
-
-	sf::RenderWindow& window;
-
-	std::list<Particle*> particles;
-	std::random_device randDevice {};
-	std::default_random_engine randGenerator { randDevice() };
-	CTransform* transform { nullptr };
-
-	bool emitting { false };
+	ParticlePool& pool;
+	ParticlePool::EmitterID emitter;
 
 public:
-	CParticle(sf::RenderWindow& target) :
-		window(target)
-	{
-		image = NULL;
-	}
+	CParticle(ParticlePool& mPool) :
+		pool(mPool),
+		emitter(mPool.CreateEmitter())
+	{}
 
 	~CParticle()
 	{
-		for (std::list<Particle*>::iterator it = particles.begin(); it != particles.end(); it++)
-		{
-			delete *it;
-		}
-		delete image;
-	};
+		pool.DestroyEmitter(emitter);
+	}
+
+	CParticle(const CParticle&) = delete;
+	CParticle& operator=(const CParticle&) = delete;
 
 	void Init() override
 	{
 		//If the entity has transform, set the defulat position to where it is.
 		if (Entity->HasComponent<CTransform>())
-		{
-			transform = &Entity->GetComponent<CTransform>();
-			position = transform->Position;
-		}
+			SetPosition(Entity->GetComponent<CTransform>().Position.x, Entity->GetComponent<CTransform>().Position.y);
 		else
-		{
-			position.x = ScreenWidth / 2;
-			position.y = ScreenHeight / 2;
-		}
-		transparent = sf::Color(0, 0, 0, 0);
+			SetPosition(ScreenWidth / 2, ScreenHeight / 2);
 	}
 
-	// Updates position, velocity and opacity of all particles.
-	void Update(float mFT) override
-	{
-		if (!emitting || image == NULL)
-			return;
-
-		Remove();
-		for (std::list<Particle*>::iterator it = particles.begin(); it != particles.end(); it++)
-		{
-			(*it)->vel.x += gravity.x * mFT;
-			(*it)->vel.y += gravity.y * mFT;
-
-			(*it)->pos.x += (*it)->vel.x * mFT * particleSpeed;
-			(*it)->pos.y += (*it)->vel.y * mFT * particleSpeed;
-
-			if (dissolve)
-				(*it)->color.a -= dissolutionRate;
-
-			if ((*it)->pos.x > image->getSize().x || (*it)->pos.x < 0
-				|| (*it)->pos.y > image->getSize().y || (*it)->pos.y < 0 || (*it)->color.a < 10)
-			{
-				delete (*it);
-				it = particles.erase(it);
-				if (it == particles.end())
-					return;
-			}
-		}
-	};
-
-	// Renders all particles onto image.
-	void Render() override
-	{
-		if (!emitting || image == NULL)
-			return;
-
-		for (std::list<Particle*>::iterator it = particles.begin(); it != particles.end(); it++)
-		{
-			if (image == NULL)
-				return;
-			image->setPixel((int)(*it)->pos.x, (int)(*it)->pos.y, (*it)->color);
-		}
-		texture.loadFromImage(*image);
-		sprite.setTexture(texture, true);
-		window.draw(sprite);
-	};
-
-private:
-	// Removes all particles from image.
-	void Remove()
-	{
-		if (!emitting || image == NULL)
-			return;
-
-		for (std::list<Particle*>::iterator it = particles.begin(); it != particles.end(); it++)
-		{
-			if (image == NULL)
-				return;
-			image->setPixel((int)(*it)->pos.x, (int)(*it)->pos.y, transparent);
-		}
-
-		if (particles.size() <= 0)
-			emitting = false;
-	};
-
-	float Randomizer(float min, float max)
-	{
-		std::uniform_real_distribution<float> unif(min, max);
-		float result = unif(randGenerator);
-
-		return result;
-	}
-
-public:
-	// Adds new particles to particles.
+	// Adds new particles to the pool.
 	void Fuel(int count)
 	{
-		float angle;
-		Particle* particle;
-
-		if (image == NULL)
-		{
-			image = new sf::Image();
-			image->create(ScreenWidth, ScreenHeight, transparent);
-		}
-
-		if (count > 0)
-			emitting = true;
-
-		for (int i = 0; i < count; ++i)
-		{
-			particle = new Particle();
-			particle->pos.x = position.x;
-			particle->pos.y = position.y;
-
-			switch (shape)
-			{
-				case Shape::CIRCLE:
-					dissolve = true;
-					angle = Randomizer(0.0f, 6.2832f);
-					particle->vel.x = Randomizer(0.0f, cos(angle));
-					particle->vel.y = Randomizer(0.0f, sin(angle));
-					break;
-				case Shape::SQUARE:
-					dissolve = false;
-					particle->vel.x = Randomizer(-1.0f, 1.0f);
-					particle->vel.y = Randomizer(-1.0f, 1.0f);
-					break;
-				default:
-					particle->vel.x = 0.5f; // Easily detected
-					particle->vel.y = 0.5f; // Easily detected
-			}
-
-			if (particle->vel.x == 0.0f && particle->vel.y == 0.0f)
-			{
-				delete particle;
-				continue;
-			}
-
-			particle->color.r = color.r;
-			particle->color.g = color.g;
-			particle->color.b = color.b;
-			particle->color.a = 255;
-			particles.push_back(particle);
-		}
-	};
+		pool.Burst(emitter, count);
+	}
 
 	void SetPosition(float x, float y)
 	{
-		position.x = x;
-		position.y = y;
+		pool.GetEmitter(emitter).Position = sf::Vector2f(x, y);
 	}
 
 	void SetColor(sf::Color mColor)
 	{
-		color = mColor;
+		pool.GetEmitter(emitter).Color = mColor;
 	}
 
 	void SetGravity(float x, float y)
 	{
-		gravity.x = x;
-		gravity.y = y;
+		pool.GetEmitter(emitter).Gravity = sf::Vector2f(x, y);
 	}
 
 	void SetParticleSpeed(float speed)
 	{
-		particleSpeed = speed;
+		pool.GetEmitter(emitter).Speed = speed;
 	}
 
 	void SetDissolve(bool enable)
 	{
-		dissolve = enable;
+		pool.GetEmitter(emitter).Dissolve = enable;
 	}
 
 	void SetDissolutionRate(unsigned char rate)
 	{
-		dissolutionRate = rate;
+		pool.GetEmitter(emitter).DissolutionRate = rate;
 	}
 
-	void SetShape(unsigned char shape)
+	void SetShape(unsigned char mShape)
 	{
-		shape = shape;
+		pool.GetEmitter(emitter).ShapeType = mShape;
 	}
 
-	int GetNumberOfParticles()
+	//Particles in the air are only an effect, they are not saved.
+	void Save(SnapshotWriter& writer) const override
 	{
-		return particles.size();
+		writer.Write(pool.GetEmitter(emitter));
 	}
-
-	std::string GetNumberOfParticlesString()
-	{
-		std::ostringstream oss;
-		oss << particles.size();
-		return oss.str();
-	};
-
-	sf::Sprite& GetSprite()
+	void Load(SnapshotReader& reader) override
 	{
-		return sprite;
+		reader.Read(pool.GetEmitter(emitter));
 	}
 };
 
@@ -435,9 +320,11 @@ public:
 	void Init() override
 	{
 		transform = &Entity->GetComponent<CTransform>();
-		sprite = &Entity->GetComponent<CSprite2D>();
 
-		//Particle is optional.
+		//Sprite and particle are optional, headless
+		//worlds like the benchmarks have neither.
+		if (Entity->HasComponent<CSprite2D>())
+			sprite = &Entity->GetComponent<CSprite2D>();
 		if (Entity->HasComponent<CParticle>())
 			particleEmitter = &Entity->GetComponent<CParticle>();
 
@@ -454,6 +341,41 @@ public:
 			DeathTimer(mFT);
 	}
 
+	void Save(SnapshotWriter& writer) const override
+	{
+		writer.Write(hitTimer);
+		writer.Write(hitCoolDown);
+		writer.Write(deathTimer);
+		writer.Write(deathCoolDown);
+		writer.WriteRandom(randGenerator);
+
+		writer.Write(Health);
+		writer.Write(Score);
+		writer.Write(SpeedMod);
+		writer.Write(IsDead);
+		writer.Write(IsInvincible);
+		writer.Write(CanBeProtect);
+		writer.Write(CanGiveScore);
+		writer.Write(CanBeControl);
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		reader.Read(hitTimer);
+		reader.Read(hitCoolDown);
+		reader.Read(deathTimer);
+		reader.Read(deathCoolDown);
+		reader.ReadRandom(randGenerator);
+
+		reader.Read(Health);
+		reader.Read(Score);
+		reader.Read(SpeedMod);
+		reader.Read(IsDead);
+		reader.Read(IsInvincible);
+		reader.Read(CanBeProtect);
+		reader.Read(CanGiveScore);
+		reader.Read(CanBeControl);
+	}
+
 	virtual void Hit(int damage)
 	{
 		HitEffect();
@@ -498,7 +420,7 @@ protected:
 			if (!IsDead)
 			{
 				HitEffect();
-				sprite->ChangeColor(sf::Color(0, 0, 0, 0));
+				ChangeColor(sf::Color(0, 0, 0, 0));
 				Health = 0;
 				IsDead = true;
 				IsInvincible = true;
@@ -524,13 +446,13 @@ protected:
 		hitTimer += mFT;
 		if (hitTimer < hitCoolDown)
 		{
-			sprite->ChangeColor(sf::Color::Green);
+			ChangeColor(sf::Color::Green);
 			IsInvincible = true;
 		}
 		else
 		{
 			hitTimer = 0;
-			sprite->ChangeColor(sf::Color::White);
+			ChangeColor(sf::Color::White);
 			IsInvincible = false;
 		}
 	}
@@ -546,6 +468,12 @@ protected:
 		}
 	}
 
+	void ChangeColor(sf::Color color)
+	{
+		if (sprite != nullptr)
+			sprite->ChangeColor(color);
+	}
+
 	void HitEffect()
 	{
 		if (particleEmitter != nullptr)
@@ -592,6 +520,10 @@ protected:
  *
  * We can use this compoenet to give an entity very
  * basic collider and moving force based on its velocity.
+ *
+ * Set 'Continuous' on fast movers, they are tested
+ * along the whole path of their last step so they
+ * can not skip over a collider between two steps.
  */
 struct CPhysics : Component
 {
@@ -604,6 +536,8 @@ public:
 	sf::Vector2f HalfSize;
 	sf::Vector2f Velocity;
 	float BorderWidth, BorderHeight;
+	bool Continuous { false };
+	sf::Vector2f LastStepPosition; //Where the last step started.
 
 	CPhysics(const sf::Vector2f& mHalfSize, const float mBorderX, const float mBorderY) :
 		HalfSize(mHalfSize),
@@ -616,10 +550,12 @@ public:
 	{
 		//'CPhysics' obviously requires 'CTransform'.
 		transform = &Entity->GetComponent<CTransform>();
+		LastStepPosition = transform->Position;
 	}
 
 	void Update(float mFT) override
 	{
+		LastStepPosition = transform->Position;
 		transform->Position += Velocity * mFT;
 		//std::cout << std::to_string(PlayerBaseSpeed * mFT) << std::endl;
 
@@ -637,6 +573,26 @@ public:
 			OnOutOfBounds(sf::Vector2f { 0.f, -1.f });
 	}
 
+	//'OnOutOfBounds' is registered again by the controllers.
+	void Save(SnapshotWriter& writer) const override
+	{
+		writer.Write(HalfSize);
+		writer.Write(Velocity);
+		writer.Write(BorderWidth);
+		writer.Write(BorderHeight);
+		writer.Write(Continuous);
+		writer.Write(LastStepPosition);
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		reader.Read(HalfSize);
+		reader.Read(Velocity);
+		reader.Read(BorderWidth);
+		reader.Read(BorderHeight);
+		reader.Read(Continuous);
+		reader.Read(LastStepPosition);
+	}
+
 	float x() const noexcept
 	{
 		return transform->Position.x;
@@ -736,6 +692,19 @@ public:
 			physics->Velocity.y = 0;
 	}
 
+	void Save(SnapshotWriter& writer) const override
+	{
+		writer.Write(slowMod);
+		writer.Write(PlayerSpeed);
+		writer.Write(Stop);
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		reader.Read(slowMod);
+		reader.Read(PlayerSpeed);
+		reader.Read(Stop);
+	}
+
 private:
 	void OnOutOfBoundsEvent(const sf::Vector2f& mSide)
 	{
@@ -783,18 +752,19 @@ private:
 	CTransform* transform { nullptr };
 	CStat* stat { nullptr };
 	sf::Vector2f direction;
-	sf::Vector2f& targetPos; //Refernce of the target position so we can keep tracking it.
+	EntityHandle target;    //Handle of the target so we can keep tracking it.
+	sf::Vector2f targetPos; //Last known position of the target.
 	EnemyMoveType moveType { EnemyMoveType::ChasePlayer };
 
 public:
-	CSimpleEnemyControl(const float mEnemySpeed, sf::Vector2f& mTarget) :
+	CSimpleEnemyControl(const float mEnemySpeed, EntityHandle mTarget) :
 		EnemySpeed(mEnemySpeed),
-		targetPos(mTarget)
+		target(mTarget)
 	{}
 
-	CSimpleEnemyControl(const float& mEnemySpeed, sf::Vector2f& mTarget, EnemyMoveType mMoveType) :
+	CSimpleEnemyControl(const float& mEnemySpeed, EntityHandle mTarget, EnemyMoveType mMoveType) :
 		EnemySpeed(mEnemySpeed),
-		targetPos(mTarget),
+		target(mTarget),
 		moveType(mMoveType)
 	{}
 
@@ -803,6 +773,7 @@ public:
 		physics = &Entity->GetComponent<CPhysics>();
 		transform = &Entity->GetComponent<CTransform>();
 		stat = &Entity->GetComponent<CStat>();
+		TrackTarget();
 
 		//Since ping pong move has no target we
 		//need to create a initial force.
@@ -834,6 +805,8 @@ public:
 			return;
 		}
 
+		TrackTarget();
+
 		switch (moveType)
 		{
 			case EnemyMoveType::ChasePlayer:
@@ -854,7 +827,41 @@ public:
 		}
 	}
 
+	void Save(SnapshotWriter& writer) const override
+	{
+		writer.Write(EnemySpeed);
+		writer.Write(Stop);
+		writer.Write(waitInterval);
+		writer.Write(waitTimer);
+		writer.Write(waitFlag);
+		writer.Write(direction);
+		writer.WriteHandle(target);
+		writer.Write(targetPos);
+		writer.Write(moveType);
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		reader.Read(EnemySpeed);
+		reader.Read(Stop);
+		reader.Read(waitInterval);
+		reader.Read(waitTimer);
+		reader.Read(waitFlag);
+		reader.Read(direction);
+		target = reader.ReadHandle();
+		reader.Read(targetPos);
+		reader.Read(moveType);
+	}
+
 private:
+	void TrackTarget()
+	{
+		//The handle goes stale once the target is freed,
+		//then we just keep heading to where it was.
+		GameEntity* t(Entity->GetManager().TryGetEntity(target));
+		if (t != nullptr)
+			targetPos = t->GetComponent<CTransform>().Position;
+	}
+
 	void ChasePlayerMove(float mFT)
 	{
 		direction = targetPos - transform->Position;
@@ -1066,6 +1073,23 @@ public:
 		Fly();
 	}
 
+	void Save(SnapshotWriter& writer) const override
+	{
+		writer.Write(isDead);
+		writer.Write(Speed);
+		writer.Write(Direction);
+		writer.Write(Stop);
+		writer.Write(Damage);
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		reader.Read(isDead);
+		reader.Read(Speed);
+		reader.Read(Direction);
+		reader.Read(Stop);
+		reader.Read(Damage);
+	}
+
 	void Fly()
 	{
 		physics->Velocity.x = Speed * Direction.x;
@@ -1168,6 +1192,20 @@ public:
 		currentEffects.push_back(info);
 	}
 
+	void Save(SnapshotWriter& writer) const override
+	{
+		writer.Write(static_cast<std::uint32_t>(currentEffects.size()));
+		for (auto& e : currentEffects)
+			writer.Write(e);
+	}
+	void Load(SnapshotReader& reader) override
+	{
+		currentEffects.clear();
+		const auto count(reader.Read<std::uint32_t>());
+		for (std::uint32_t i = 0; i < count && reader.IsValid(); ++i)
+			currentEffects.push_back(reader.Read<ConsumableInfo>());
+	}
+
 private:
 	void ProcessEffect(float mFT)
 	{
@@ -0,0 +1,104 @@
+#pragma once
+#include "ComponentSystem/EntityHandle.h"
+#include <cstdint>
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines ContactCache, the touching
+///pairs kept from one collision step to the next.
+///
+///Every step the CollisionManager adds the pairs
+///touching now. Update compares them with the last
+///step and reports each one as entering, staying
+///or exiting, so a response only does its work
+///when a contact starts or ends.
+///
+///Contacts are sorted by key, so they are reported
+///in the same order whatever order they were added.
+///
+/////////////////////////////////////////////////
+struct Contact
+{
+	ComponentSystem::EntityHandle A;
+	ComponentSystem::EntityHandle B;
+	std::uint32_t Response; //Which response table entry handles it.
+
+	std::uint64_t Key() const noexcept
+	{
+		return (static_cast<std::uint64_t>(A.Value) << 32) | B.Value;
+	}
+};
+
+inline bool operator<(const Contact& a, const Contact& b) noexcept
+{
+	return a.Key() < b.Key() || (a.Key() == b.Key() && a.Response < b.Response);
+}
+
+inline bool operator==(const Contact& a, const Contact& b) noexcept
+{
+	return a.Key() == b.Key() && a.Response == b.Response;
+}
+
+class ContactCache
+{
+private:
+	std::vector<Contact> previous;
+	std::vector<Contact> current;
+	//Every entity in a contact this step, sorted.
+	std::vector<std::uint32_t> touching;
+
+public:
+	//Add a contact touching this step, twice is the same as once.
+	void Add(const Contact& contact)
+	{
+		current.emplace_back(contact);
+	}
+
+	//Ends the step: calls 'mEnter', 'mStay' or 'mExit' with each
+	//contact, in key order.
+	template <typename Enter, typename Stay, typename Exit>
+	void Update(Enter&& mEnter, Stay&& mStay, Exit&& mExit);
+
+	//True when 'entity' is in any contact touching now, already
+	//during the calls of Update.
+	bool IsTouching(ComponentSystem::EntityHandle entity) const noexcept;
+
+	//Contacts of the last Update.
+	const std::vector<Contact>& GetContacts() const noexcept
+	{
+		return previous;
+	}
+
+	//Forget every contact without exiting them, e.g. when the
+	//world is rebuilt and the handles mean nothing anymore.
+	void Clear() noexcept;
+
+private:
+	void SortCurrent();
+	void FinishUpdate();
+};
+
+template <typename Enter, typename Stay, typename Exit>
+void ContactCache::Update(Enter&& mEnter, Stay&& mStay, Exit&& mExit)
+{
+	SortCurrent();
+
+	//Both lists are sorted, walk them side by side.
+	std::size_t i { 0 };
+	std::size_t j { 0 };
+	while (i < previous.size() || j < current.size())
+	{
+		if (j == current.size() || (i < previous.size() && previous[i] < current[j]))
+			mExit(previous[i++]);
+		else if (i == previous.size() || current[j] < previous[i])
+			mEnter(current[j++]);
+		else
+		{
+			mStay(current[j++]);
+			++i;
+		}
+	}
+
+	FinishUpdate();
+}
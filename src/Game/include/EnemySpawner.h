@@ -1,4 +1,5 @@
 #pragma once
+#include "AABBTree.h"
 #include "EntityFactory.h"
 #include "GlobalGameSettings.h"
 
@@ -14,6 +15,7 @@ private:
 
 	EntityFactory& factory;
 	sf::RenderWindow& window;
+	const AABBTree* obstacles { nullptr };
 
 	std::random_device randDevice {};
 	std::default_random_engine randGenerator { randDevice() };
@@ -25,6 +27,11 @@ public:
 	{}
 
 	void SetCenter(sf::Vector2f& center);
+	//Enemies do not spawn inside these.
+	void SetObstacles(const AABBTree* mObstacles)
+	{
+		obstacles = mObstacles;
+	}
 
 	void GenerateEnemy(int count);
 	void GenerateEnemy(EnemySpawnMode mode);
@@ -35,8 +42,15 @@ public:
 	void GeneratePongs(int count);
 	void GenerateChargers(int count);
 
+	//Spawn positions come from 'randGenerator' only, so
+	//saving it is enough to replay the same waves.
+	void Save(ComponentSystem::SnapshotWriter& writer) const;
+	void Load(ComponentSystem::SnapshotReader& reader);
+
 	int RandomX();
 	int RandomY();
 	int RandomSign();
 	void CheckTooClose(int& x, int& y);
+	//Roll the offset again while it is inside an obstacle.
+	sf::Vector2f GetSpawnPosition(int& x, int& y);
 };
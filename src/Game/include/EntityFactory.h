@@ -2,6 +2,8 @@
 #include "ComponentSystem/EntityManager.h"
 #include "Components.h"
 #include "GlobalGameSettings.h"
+#include "ParticlePool.h"
+#include "TextureCache.h"
 #include "eventpp/eventdispatcher.h"
 
 class EntityFactory
@@ -9,12 +11,22 @@ class EntityFactory
 private:
 	ComponentSystem::EntityManager& manager;
 	eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& gameDispatcher;
+	TextureCache& textures;
+	ParticlePool& particles;
+
+	void BuildProjectile(ComponentSystem::GameEntity& projectile, const sf::Vector2f& position, const sf::Vector2f& direction,
+		sf::RenderWindow& target, const float& speedMod, const int& damage) noexcept;
 
 public:
+	//'mTextures' and 'mParticles' must outlive the entities of
+	//'mManager', sprites and emitters give back what they hold.
 	EntityFactory(ComponentSystem::EntityManager& mManager,
-		eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& mDispatcher) :
+		eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& mDispatcher,
+		TextureCache& mTextures, ParticlePool& mParticles) :
 		manager(mManager),
-		gameDispatcher(mDispatcher)
+		gameDispatcher(mDispatcher),
+		textures(mTextures),
+		particles(mParticles)
 	{}
 
 	ComponentSystem::GameEntity& CreatePlayer(const sf::Vector2f& position, sf::RenderWindow& target) noexcept;
@@ -26,6 +38,14 @@ public:
 
 	ComponentSystem::GameEntity& CreateProjectile(const sf::Vector2f& position, const sf::Vector2f& direction,
 		sf::RenderWindow& target, const float& speedMod, const int& damage) noexcept;
+	//Same as 'CreateProjectile' but spawned in the next Refresh(),
+	//safe to call while entities are being iterated.
+	void QueueProjectile(const sf::Vector2f& position, const sf::Vector2f& direction,
+		sf::RenderWindow& target, const float& speedMod, const int& damage);
 
 	ComponentSystem::GameEntity& CreateObstacle(const sf::Vector2f& position, sf::RenderWindow& target) noexcept;
+
+	//'ComponentLoader' of 'EntityManager::LoadSnapshot'.
+	ComponentSystem::Component* LoadComponent(ComponentSystem::GameEntity& entity, ComponentSystem::ComponentID id,
+		ComponentSystem::SnapshotReader& reader, sf::RenderWindow& target);
 };
@@ -8,6 +8,8 @@
 #include "GameClock.h"
 #include "GlobalGameSettings.h"
 #include "HUDManager.h"
+#include "SpriteBatch.h"
+#include "Systems.h"
 #include "Platform/Platform.hpp"
 #include "WeaponController.h"
 #include "eventpp/eventdispatcher.h"
@@ -37,6 +39,10 @@ private:
 	sf::RenderWindow* window;
 	util::Platform platform;
 
+	//Declared before the manager so they outlive it.
+	ComponentSystem::ThreadPool threadPool;
+	TextureCache textures;
+	ParticlePool particles;
 	ComponentSystem::EntityManager manager;
 	CollisionManager* collisionManager { nullptr };
 	EntityFactory* entityFactory { nullptr };
@@ -44,12 +50,16 @@ private:
 	EnemySpawner* enemySpawner { nullptr };
 	HUDManager* hudManager { nullptr };
 	AudioManager* audioManager { nullptr };
+	SpriteBatch spriteBatch;
 
 	GameClock* gameClock { nullptr };
 	float currentSpawnCount { 5 };
 	bool spawnLock { false };
 	EnemySpawnMode currentWaveMode { EnemySpawnMode::Easy };
 
+	//Last stage saved with F5, F9 restores it.
+	ComponentSystem::SnapshotWriter stageSnapshot;
+
 	void Init();
 	void InitLevel();
 	void InitPlayer();
@@ -60,6 +70,8 @@ private:
 
 	void ClearStage();
 	void PauseStage();
+	void SaveStage();
+	void RestoreStage();
 
 	void PollingEvent();
 	void OnGameStateChange(EventNames state);
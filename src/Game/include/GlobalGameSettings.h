@@ -14,6 +14,12 @@ constexpr float BulletBaseSpeed = 400.f;
 constexpr float HitCoolDown = 0.1f;
 constexpr int HurtPenalty = -50;
 
+//Effects
+constexpr std::size_t MaxParticles = 8192; //Bursts stop spawning when all are alive.
+
+//Collision
+constexpr float CollisionCellSize = 64.f; //About one enemy sprite wide.
+
 //Update Method
 constexpr bool UseDeltaTime { true };
 
@@ -26,6 +32,8 @@ constexpr int WaveModeInterval = WaveInterval * 3;
 constexpr int EliteInterval = (DefaultTimeLimit / WaveInterval) * 0.5f * WaveInterval;
 constexpr int WaveBaseSpawn = 5;
 constexpr int WaveSpawnOffset = 2;
+constexpr float SpawnClearance = 32.f; //Half size of the room an enemy needs.
+constexpr int SpawnTries = 8;
 
 //Game States
 enum GameStates : std::size_t
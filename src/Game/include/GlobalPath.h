@@ -5,6 +5,8 @@ const std::string enemyTexturePath2 = "Resources/Texture/Character/coward.png";
 const std::string enemyTexturePath3 = "Resources/Texture/Character/pong.png";
 const std::string enemyTexturePath4 = "Resources/Texture/Character/elite.png";
 const std::string rockTexturePath = "Resources/Texture/Object/rock.png";
+//Written by 'make atlas', the textures above are looked up in it.
+const std::string atlasManifestPath = "Resources/Texture/Atlas/atlas.bin";
 
 const std::string fontPath1 = "Resources/Font/Mincho/TrueType/Mincho_H1.ttf";
 const std::string fontPath2 = "Resources/Font/Mincho/TrueType/Mincho_H2.ttf";
@@ -15,4 +17,5 @@ const std::string BGMPath = "Resources/Audio/BGM.ogg";
 const std::string ShootSoundPath = "Resources/Audio/Gun.wav";
 const std::string HurtSoundPath = "Resources/Audio/Hurt.wav";
 const std::string DieSoundPath = "Resources/Audio/Die.wav";
-const std::string DieSoundPath2 = "Resources/Audio/PlayerDie.wav";
\ No newline at end of file
+const std::string DieSoundPath2 = "Resources/Audio/PlayerDie.wav";
+const std::string SnapshotPath = "snapshot.bin";
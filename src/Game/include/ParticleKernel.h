@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines the batched particle step.
+///
+///Particles are stored field by field, so four
+///(SSE) or eight (AVX2) of them are moved, faded
+///and checked together. The step leaves a bitmask
+///with one bit per particle still alive, then
+///'CompactParticles' packs the living ones to the
+///front, in order, moving nothing until the first
+///death.
+///
+///The fastest kernel the CPU runs is picked the
+///first time one is needed, with a scalar one for
+///CPUs and targets without SSE.
+///
+/////////////////////////////////////////////////
+struct Particle
+{
+	sf::Vector2f Position;
+	sf::Vector2f Velocity;
+	sf::Vector2f Gravity;
+	float Speed;
+	float Fade; //Alpha lost per update, 0 if it does not dissolve.
+	sf::Color Color;
+};
+
+//Particles split into one array per field.
+struct ParticleBatch
+{
+	std::vector<float> X;
+	std::vector<float> Y;
+	std::vector<float> VelocityX;
+	std::vector<float> VelocityY;
+	std::vector<float> GravityX;
+	std::vector<float> GravityY;
+	std::vector<float> Speed;
+	std::vector<float> Alpha;
+	std::vector<float> Fade;
+	std::vector<sf::Color> Color; //Alpha is the one above.
+
+	std::size_t Size() const noexcept
+	{
+		return X.size();
+	}
+
+	void Reserve(std::size_t capacity);
+	void Clear() noexcept;
+	void Add(const Particle& particle);
+	//Copies particle 'from' over particle 'to'.
+	void Move(std::size_t from, std::size_t to) noexcept;
+	//Keeps the first 'count' particles.
+	void Shrink(std::size_t count) noexcept;
+};
+
+enum class ParticleKernelType
+{
+	Scalar,
+	SSE,
+	AVX2
+};
+
+//Moves every particle by 'mFT' seconds and sets bit 'i % 64' of
+//'alive[i / 64]' when particle 'i' is still on screen and visible.
+//Every word is written.
+using ParticleKernel = void (*)(ParticleBatch& batch, float mFT, std::uint64_t* alive);
+
+//Null when this build or this CPU can not run 'type'.
+ParticleKernel GetParticleKernel(ParticleKernelType type) noexcept;
+//The fastest kernel this CPU runs.
+ParticleKernelType GetBestParticleKernelType() noexcept;
+const char* GetParticleKernelName(ParticleKernelType type) noexcept;
+
+//Keeps the particles whose bit is set in 'alive', in order.
+//Returns how many are left.
+std::size_t CompactParticles(ParticleBatch& batch, const std::vector<std::uint64_t>& alive) noexcept;
+
+//One step with the fastest kernel, then the compaction.
+void UpdateParticles(ParticleBatch& batch, float mFT, std::vector<std::uint64_t>& alive);
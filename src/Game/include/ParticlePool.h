@@ -0,0 +1,84 @@
+#pragma once
+#include "GlobalGameSettings.h"
+#include "ParticleKernel.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines ParticlePool, which owns every
+///particle of the game.
+///
+///Particles sit in one ParticleBatch of fixed
+///capacity, moved by the particle kernels and drawn
+///as one vertex array of points, so the cost of
+///effects follows how many particles are alive, not
+///how many entities can emit them.
+///
+///An emitter is only the settings of a burst, found
+///by its ID. A burst copies them into its particles,
+///which then live on their own, even once the
+///emitter is gone.
+///
+/////////////////////////////////////////////////
+enum Shape
+{
+	CIRCLE,
+	SQUARE
+};
+
+struct ParticleEmitter
+{
+	sf::Vector2f Position;
+	sf::Vector2f Gravity; //Added to velocities every second.
+	sf::Color Color;
+	float Speed { 1.f };
+	bool Dissolve { false };
+	std::uint8_t DissolutionRate { 4 }; //Alpha lost per update.
+	std::uint8_t ShapeType { Shape::SQUARE };
+};
+
+class ParticlePool
+{
+public:
+	using EmitterID = std::uint32_t;
+
+private:
+	ParticleBatch particles;
+	std::vector<std::uint64_t> alive; //Scratch space of the update.
+	std::size_t capacity;
+	std::vector<ParticleEmitter> emitters;
+	std::vector<EmitterID> freeEmitters;
+	sf::VertexArray vertices { sf::Points };
+	std::default_random_engine random { std::random_device {}() };
+
+public:
+	explicit ParticlePool(std::size_t mCapacity = MaxParticles);
+
+	EmitterID CreateEmitter();
+	//The ID may be given to the next emitter, its particles stay.
+	void DestroyEmitter(EmitterID id);
+	ParticleEmitter& GetEmitter(EmitterID id) noexcept
+	{
+		return emitters[id];
+	}
+
+	//Spawns 'count' particles from emitter 'id', less when the pool
+	//is full. Returns how many were spawned.
+	std::size_t Burst(EmitterID id, int count);
+	//Moves every particle, drops the ones faded or off screen.
+	void Update(float mFT);
+	void Draw(sf::RenderTarget& target);
+	//Kill every particle, emitters are kept.
+	void Clear() noexcept;
+
+	std::size_t Size() const noexcept
+	{
+		return particles.Size();
+	}
+	std::size_t GetCapacity() const noexcept
+	{
+		return capacity;
+	}
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include "Broadphase.h"
+
+/////////////////////////////////////////////////
+///
+///This file defines SpatialHash, a uniform grid
+///broadphase.
+///
+///The world is cut in square cells and every proxy
+///is put in each cell it covers. Cells are hashed,
+///so the grid has no bounds and only costs memory
+///for the cells in use.
+///
+///The grid is rebuilt from scratch on every Update,
+///entries are sorted by bucket with a counting sort
+///so a lookup reads each bucket as one array slice.
+///
+///Pick a cell size close to the size of the boxes:
+///smaller puts a box in many cells, bigger makes
+///each query look at many far away boxes. Boxes
+///covering more than 'MaxProxyCells' cells are kept
+///out of the grid in a list every lookup reads.
+///
+/////////////////////////////////////////////////
+class SpatialHash final : public Broadphase
+{
+private:
+	struct CellRange
+	{
+		int MinX, MinY, MaxX, MaxY;
+	};
+
+	struct Entry
+	{
+		std::uint32_t Bucket;
+		std::uint32_t Id;
+	};
+
+	static constexpr std::size_t MaxProxyCells { 256 };
+	//Cell coordinates are clamped to this, so far away or broken
+	//boxes still give a cell count that fits.
+	static constexpr int MaxCell { 1 << 24 };
+	static constexpr std::size_t MaxBuckets { std::size_t { 1 } << 24 };
+
+	float cellSize;
+	float inverseCellSize;
+
+	std::vector<BroadphaseProxy> proxies;
+	std::vector<Entry> entries;
+	std::vector<std::uint32_t> oversized;
+	std::uint32_t bucketMask { 0 };
+	//Ids of bucket 'b' are in [bucketStarts[b], bucketStarts[b + 1]).
+	std::vector<std::uint32_t> bucketStarts;
+	std::vector<std::uint32_t> bucketIds;
+
+	//A proxy in many cells is only looked at once per lookup.
+	std::vector<std::uint32_t> stamps;
+	std::uint32_t stamp { 0 };
+
+	CellRange GetCellRange(const AABB& box) const noexcept;
+	static std::uint64_t GetCellCount(const CellRange& range) noexcept;
+	std::uint32_t GetBucket(int x, int y) const noexcept;
+	void NextStamp() noexcept;
+	//Calls 'mFunc(id)' once for every proxy sharing a cell with 'box'.
+	template <typename F>
+	void ForEachNearby(const AABB& box, F&& mFunc);
+
+public:
+	explicit SpatialHash(float mCellSize);
+
+	void SetCellSize(float mCellSize) noexcept;
+	float GetCellSize() const noexcept
+	{
+		return cellSize;
+	}
+
+	const char* GetName() const noexcept override
+	{
+		return "Spatial hash";
+	}
+
+	void Update(const std::vector<BroadphaseProxy>& mProxies) override;
+	void Query(const AABB& box, std::uint32_t mask, std::vector<std::uint32_t>& result) override;
+};
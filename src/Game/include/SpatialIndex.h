@@ -0,0 +1,108 @@
+#pragma once
+#include "ComponentSystem/EntityHandle.h"
+#include "AABBTree.h"
+#include "Broadphase.h"
+#include "GlobalGameSettings.h"
+#include <cstdint>
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines SpatialIndex, area, nearest
+///and ray queries on the collision world.
+///
+///It answers from what the broadphase built on the
+///last collision step, plus the obstacle tree, so a
+///query only looks at nearby colliders instead of a
+///whole group. Positions are the ones of that step.
+///
+///Groups are masks of '1u << EntityGroup', only
+///groups that collide with something are indexed.
+///Results are handles written to a buffer of the
+///caller, nothing is allocated once the scratch
+///space has grown. Check the handles before use,
+///an entity may be gone since the step.
+///
+/////////////////////////////////////////////////
+class SpatialIndex
+{
+public:
+	struct RayHit
+	{
+		ComponentSystem::EntityHandle Entity;
+		float Time; //Along the ray, 0 at the origin and 1 at the end.
+	};
+
+private:
+	struct Entry
+	{
+		ComponentSystem::EntityHandle Entity;
+		AABB Bounds;
+	};
+
+	struct Candidate
+	{
+		float Distance; //Squared.
+		ComponentSystem::EntityHandle Entity;
+	};
+
+	Broadphase* broadphase { nullptr };
+	std::vector<Entry> entries; //Same order as the broadphase proxies.
+	const AABBTree* obstacles { nullptr };
+	std::vector<Entry> obstacleEntries; //By obstacle tree id.
+
+	//Scratch space, reused by every query.
+	std::vector<std::uint32_t> ids;
+	std::vector<Candidate> candidates;
+
+	//Calls 'mVisit(entity, bounds)' on every entry of 'groups'
+	//overlapping 'box'.
+	template <typename Visit>
+	void ForEachInBox(const AABB& box, std::uint32_t groups, Visit&& mVisit);
+
+public:
+	//Called by the CollisionManager, 'Add' once per proxy and in
+	//the same order.
+	void Clear(Broadphase* mBroadphase) noexcept;
+	void Add(ComponentSystem::EntityHandle entity, const AABB& bounds);
+	void SetObstacles(const AABBTree* mObstacles, const std::vector<ComponentSystem::EntityHandle>& entities, const std::vector<AABB>& bounds);
+
+	//Every entity overlapping 'box'. Writes at most 'capacity' handles
+	//to 'result' and returns how many were found, maybe more.
+	std::size_t QueryAABB(const AABB& box, std::uint32_t groups, ComponentSystem::EntityHandle* result, std::size_t capacity);
+	//Every entity whose box is at most 'radius' away from 'center',
+	//returns like 'QueryAABB'.
+	std::size_t QueryRadius(const sf::Vector2f& center, float radius, std::uint32_t groups, ComponentSystem::EntityHandle* result, std::size_t capacity);
+	//The 'k' entities closest to 'center', no further than 'maxRadius',
+	//closest first. Returns how many were written.
+	std::size_t QueryKNearest(const sf::Vector2f& center, float maxRadius, std::uint32_t groups, ComponentSystem::EntityHandle* result, std::size_t k);
+	//First entity the segment from 'from' to 'to' touches, false if none.
+	bool Raycast(const sf::Vector2f& from, const sf::Vector2f& to, std::uint32_t groups, RayHit& hit);
+};
+
+template <typename Visit>
+void SpatialIndex::ForEachInBox(const AABB& box, std::uint32_t groups, Visit&& mVisit)
+{
+	const std::uint32_t obstacleGroup(1u << EntityGroup::Obstacle);
+	if (broadphase != nullptr && (groups & ~obstacleGroup) != 0)
+	{
+		ids.clear();
+		broadphase->Query(box, groups & ~obstacleGroup, ids);
+		for (auto id : ids)
+		{
+			//Continuous proxies cover their whole step, so test
+			//the box again.
+			const Entry& e(entries[id]);
+			if (Overlaps(e.Bounds, box))
+				mVisit(e.Entity, e.Bounds);
+		}
+	}
+
+	if (obstacles != nullptr && (groups & obstacleGroup) != 0)
+	{
+		ids.clear();
+		obstacles->Query(box, ids);
+		for (auto id : ids)
+			mVisit(obstacleEntries[id].Entity, obstacleEntries[id].Bounds);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "ComponentSystem/EntityManager.h"
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines SpriteBatch, which draws every
+///visible CSprite2D with one draw call per texture.
+///
+///Each sprite becomes a quad of four vertices, with
+///its transform, texture rect and colour baked in,
+///appended to the vertex array of its texture. The
+///arrays are kept between frames so their memory
+///is reused.
+///
+///Sprites share textures through the TextureCache,
+///so there are only as many batches as files, or
+///as atlas pages once the atlas is built.
+///
+///Sprites of one texture are drawn in the order
+///they were added, textures in the order they were
+///first seen. Overlapping sprites of two textures
+///may swap compared to drawing them one by one.
+///
+/////////////////////////////////////////////////
+class SpriteBatch
+{
+private:
+	struct Batch
+	{
+		const sf::Texture* Texture;
+		sf::VertexArray Quads;
+	};
+
+	std::vector<Batch> batches;
+	std::size_t spriteCount { 0 };
+	std::size_t drawCalls { 0 };
+
+public:
+	//Start a frame, the batches keep their memory.
+	void Clear() noexcept;
+
+	void Add(const sf::Sprite& sprite);
+	//Every visible CSprite2D of 'manager'.
+	void AddSprites(ComponentSystem::EntityManager& manager);
+
+	void Draw(sf::RenderTarget& target);
+
+	//The quads of 'texture' since the last Clear, or
+	//nullptr if it was never added.
+	const sf::VertexArray* GetQuads(const sf::Texture* texture) const noexcept;
+
+	std::size_t GetSpriteCount() const noexcept
+	{
+		return spriteCount;
+	}
+	//Of the last Draw.
+	std::size_t GetDrawCalls() const noexcept
+	{
+		return drawCalls;
+	}
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include "AABBKernel.h"
+#include "Broadphase.h"
+
+/////////////////////////////////////////////////
+///
+///This file defines SweepAndPrune, a broadphase
+///that keeps every proxy sorted on the X axis.
+///
+///The sorted endpoints are kept between steps. Most
+///colliders barely move in one fixed step, so the
+///list is almost sorted already and an insertion
+///sort repairs it in close to linear time. A sweep
+///over the list then tests each box on Y against the
+///boxes it overlaps on X, with the batched kernel
+///when there are many of them.
+///
+///Works best when proxy indices stay the same from
+///one step to the next.
+///
+/////////////////////////////////////////////////
+class SweepAndPrune final : public Broadphase
+{
+private:
+	struct Endpoint
+	{
+		float Value;
+		std::uint32_t Data; //Proxy index << 1, low bit set on the right edge.
+
+		std::uint32_t Id() const noexcept
+		{
+			return Data >> 1;
+		}
+		bool IsMax() const noexcept
+		{
+			return (Data & 1u) != 0;
+		}
+	};
+
+	std::vector<BroadphaseProxy> proxies;
+	std::vector<Endpoint> endpoints;
+	float maxWidth { 0.f };
+
+	//Proxies the sweep is inside of, and where each one is.
+	std::vector<std::uint32_t> active;
+	std::vector<std::uint32_t> activePositions;
+	AABBBatch activeBounds; //Same order as 'active'.
+	std::vector<std::uint64_t> hits;
+	static constexpr std::size_t MinBatchSize { 64 };
+
+	static bool IsBefore(const Endpoint& a, const Endpoint& b) noexcept;
+	void SyncEndpoints();
+	void SortEndpoints();
+	void Sweep();
+
+public:
+	const char* GetName() const noexcept override
+	{
+		return "Sweep and prune";
+	}
+
+	void Update(const std::vector<BroadphaseProxy>& mProxies) override;
+	void Query(const AABB& box, std::uint32_t mask, std::vector<std::uint32_t>& result) override;
+};
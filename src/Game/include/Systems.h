@@ -0,0 +1,113 @@
+#pragma once
+#include "ComponentSystem/System.h"
+#include "Components.h"
+
+/////////////////////////////////////////////////
+///
+///This file defines the Systems of the game.
+///
+///The EntityManager runs them in the order they are
+///added in Game::Init(). Anything without a System
+///(controllers, projectiles...) is run by
+///LegacyUpdateSystem.
+///
+///Each System declares what it reads and writes.
+///Systems marked parallel only write to the entity
+///being updated, so their chunks run on all cores.
+///
+/////////////////////////////////////////////////
+namespace ComponentSystem
+{
+/*
+ * Enemy movement, sets CPhysics velocity so it
+ * must run before PhysicsSystem.
+ *
+ * Reads the CTransform of the target, only players
+ * are targets and no enemy writes to them.
+ */
+class EnemyAISystem final : public TypedSystem<CSimpleEnemyControl>
+{
+public:
+	EnemyAISystem() :
+		TypedSystem("EnemyAI")
+	{
+		DeclareAccess(GetComponentBitset<CStat>(), GetComponentBitset<CSimpleEnemyControl, CPhysics, CTransform>());
+		SetParallel(true);
+	}
+};
+
+/*
+ * Moves CTransform by CPhysics velocity and fires
+ * the out of bounds callbacks.
+ */
+class PhysicsSystem final : public TypedSystem<CPhysics>
+{
+public:
+	PhysicsSystem() :
+		TypedSystem("Physics")
+	{
+		//The out of bounds callbacks belong to the controllers,
+		//projectiles destroy themselves through the CommandBuffer.
+		DeclareAccess(GetComponentBitset<CSimpleEnemyControl, CPlayerControl>(), GetComponentBitset<CPhysics, CTransform, CProjectile>());
+		SetParallel(true);
+	}
+};
+
+/*
+ * Death checks and hit/death timers of CStat.
+ *
+ * It dispatches game events, so it is left undeclared
+ * and runs alone on the main thread.
+ */
+class StatSystem final : public TypedSystem<CStat>
+{
+public:
+	StatSystem() :
+		TypedSystem("Stat")
+	{}
+};
+
+/*
+ * Copies CTransform into CSprite2D, last so sprites
+ * are drawn where physics left them this frame.
+ */
+class SpriteSyncSystem final : public TypedSystem<CSprite2D>
+{
+public:
+	SpriteSyncSystem() :
+		TypedSystem("SpriteSync")
+	{
+		DeclareAccess(GetComponentBitset<CTransform>(), GetComponentBitset<CSprite2D>());
+		SetParallel(true);
+	}
+};
+
+/*
+ * Moves every particle of the ParticlePool, the
+ * CParticle emitters have nothing to update.
+ *
+ * Only hit effects burst into the pool, from the
+ * collision step, the weapons and StatSystem, so
+ * never while this runs.
+ */
+class ParticleSystem final : public System
+{
+private:
+	ParticlePool& pool;
+
+public:
+	explicit ParticleSystem(ParticlePool& mPool) :
+		System("Particles", GetComponentBitset<CParticle>()),
+		pool(mPool)
+	{
+		DeclareAccess(ComponentBitset {}, GetComponentBitset<CParticle>());
+	}
+
+	void Update(EntityManager& manager, float mFT) override
+	{
+		UNUSED(manager);
+		pool.Update(mFT);
+	}
+};
+
+}
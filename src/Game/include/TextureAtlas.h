@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/////////////////////////////////////////////////
+///
+///This file defines the texture atlas: every
+///sprite of Resources/Texture packed into a few
+///big pages, so sprites of different files share
+///one texture and the SpriteBatch draws them in
+///one call.
+///
+///'make atlas' builds tools/AtlasPacker, which
+///packs the files with 'PackAtlas' and writes the
+///pages next to an AtlasManifest. The game loads
+///the manifest through the TextureCache and falls
+///back to the loose files when there is none.
+///
+///Layout (version 1), plain values as the
+///SnapshotWriter writes them:
+///  header  magic, version, page count, region count
+///  pages   file name, next to the manifest
+///  regions texture path, page, left, top, width,
+///          height
+///
+/////////////////////////////////////////////////
+constexpr std::uint32_t AtlasMagic { 0x534C5441 }; //"ATLS"
+constexpr std::uint32_t AtlasVersion { 1 };
+
+//Big enough for every sprite of the game on one page,
+//small enough for any graphics card.
+constexpr unsigned AtlasPageSize { 1024 };
+//Empty pixels around each region, so smoothing never
+//samples a neighbour.
+constexpr unsigned AtlasPadding { 2 };
+
+struct AtlasRegion
+{
+	std::uint16_t Page;
+	std::uint16_t Left;
+	std::uint16_t Top;
+	std::uint16_t Width;
+	std::uint16_t Height;
+};
+
+struct AtlasManifest
+{
+	std::vector<std::string> Pages;
+	//Texture paths and where each one went, same order.
+	std::vector<std::string> Names;
+	std::vector<AtlasRegion> Regions;
+
+	bool Save(const std::string& path) const;
+	//False if the file is missing or not a manifest of this version.
+	bool Load(const std::string& path);
+};
+
+//Places images of 'sizes' on pages of 'pageSize' squared, in rows of
+//the tallest first. 'regions[i]' is where image 'i' goes. Returns the
+//page count, 0 if an image is bigger than a page.
+std::size_t PackAtlas(const std::vector<sf::Vector2u>& sizes, unsigned pageSize, unsigned padding, std::vector<AtlasRegion>& regions);
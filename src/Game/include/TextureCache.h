@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/////////////////////////////////////////////////
+///
+///This file defines TextureCache, which loads each
+///texture file once and shares it.
+///
+///Sprites hold a shared reference, so spawning one
+///more bullet or enemy neither reads the disk nor
+///uploads a texture. The cache keeps every texture
+///until 'Prune' drops the ones no sprite uses.
+///
+///With an atlas loaded, a packed file is a region
+///of an atlas page instead of a texture of its own.
+///
+/////////////////////////////////////////////////
+struct TextureRegion
+{
+	std::shared_ptr<const sf::Texture> Texture;
+	sf::IntRect Rect;
+};
+
+class TextureCache
+{
+private:
+	//A file that failed to load is kept as nullptr, so it
+	//is not read again on every spawn.
+	std::unordered_map<std::string, std::shared_ptr<const sf::Texture>> textures;
+	//Packed files by path, they hold their page.
+	std::unordered_map<std::string, TextureRegion> regions;
+
+public:
+	//Loads 'path' the first time, nullptr if it can not.
+	std::shared_ptr<const sf::Texture> Get(const std::string& path);
+
+	//Loads the pages of an atlas manifest, see TextureAtlas.h. False
+	//and nothing changes if there is no atlas or a page is missing.
+	bool LoadAtlas(const std::string& manifestPath);
+	//Where 'path' was packed, or the whole of its own texture if it
+	//was not.
+	TextureRegion GetRegion(const std::string& path);
+
+	//Drop the textures only the cache holds, returns how many.
+	std::size_t Prune();
+
+	std::size_t Size() const noexcept
+	{
+		return textures.size();
+	}
+};
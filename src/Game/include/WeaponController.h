@@ -20,15 +20,18 @@ private:
 	ComponentSystem::EntityManager& manager;
 	eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& gameDispatcher;
 	sf::RenderWindow& window;
-	sf::Vector2f& weaponMountPoint;
+	ComponentSystem::EntityHandle owner; //The weapon is mounted on its owner.
 	bool stop { true };
 
 public:
 	WeaponController(const WeaponType mType, EntityFactory& mFactory, ComponentSystem::EntityManager& mManager,
-		eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& mDispatcher, sf::RenderWindow& mWindow, sf::Vector2f& mPos);
+		eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>& mDispatcher, sf::RenderWindow& mWindow, ComponentSystem::EntityHandle mOwner);
 
 	void Init();
 	void Update(float mFT);
+	//Mount the weapon on another entity, e.g. the player
+	//restored from a snapshot.
+	void SetOwner(ComponentSystem::EntityHandle mOwner);
 	void Attack();
 
 private:
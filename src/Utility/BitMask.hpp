@@ -0,0 +1,42 @@
+#ifndef UTIL_BIT_MASK_HPP
+#define UTIL_BIT_MASK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Masks with one bit per item, bit 'i % 64' of word 'i / 64', as the batched kernels write them.
+namespace util
+{
+// Words needed for 'count' items.
+inline std::size_t GetHitWords(std::size_t count) noexcept
+{
+	return (count + 63) / 64;
+}
+
+// Index of the lowest set bit, 'bits' is not zero.
+inline std::size_t GetLowestBit(std::uint64_t bits) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<std::size_t>(__builtin_ctzll(bits));
+#else
+	std::size_t bit { 0 };
+	while (((bits >> bit) & 1u) == 0)
+		++bit;
+	return bit;
+#endif
+}
+
+// Calls 'mFunc(i)' for every bit set in 'hits', lowest first.
+template <typename F>
+void ForEachHit(const std::vector<std::uint64_t>& hits, F&& mFunc)
+{
+	for (std::size_t w = 0; w < hits.size(); ++w)
+	{
+		for (std::uint64_t bits = hits[w]; bits != 0; bits &= bits - 1)
+			mFunc(w * 64 + GetLowestBit(bits));
+	}
+}
+}
+
+#endif // UTIL_BIT_MASK_HPP
@@ -0,0 +1,50 @@
+#ifndef UTIL_CPU_FEATURES_HPP
+#define UTIL_CPU_FEATURES_HPP
+
+// SIMD code paths are only built for x86, other targets use the scalar ones.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define UTIL_X86 1
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+	#endif
+#endif
+
+// Builds one function for an instruction set the rest of the project is not built for.
+#if defined(UTIL_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define UTIL_TARGET(isa) __attribute__((target(isa)))
+#else
+	#define UTIL_TARGET(isa)
+#endif
+
+namespace util
+{
+struct CpuFeatures
+{
+	bool SSE2 { false };
+	bool AVX2 { false };
+};
+
+// Read once, the first time it is asked for.
+inline const CpuFeatures& GetCpuFeatures() noexcept
+{
+	static const CpuFeatures features([]() {
+		CpuFeatures found;
+#if defined(UTIL_X86) && (defined(__GNUC__) || defined(__clang__))
+		__builtin_cpu_init();
+		found.SSE2 = __builtin_cpu_supports("sse2");
+		found.AVX2 = __builtin_cpu_supports("avx2");
+#elif defined(UTIL_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		found.SSE2 = (info[3] & (1 << 26)) != 0;
+		const bool osSavesAvx((info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6);
+		__cpuidex(info, 7, 0);
+		found.AVX2 = osSavesAvx && (info[1] & (1 << 5)) != 0;
+#endif
+		return found;
+	}());
+	return features;
+}
+}
+
+#endif // UTIL_CPU_FEATURES_HPP
@@ -0,0 +1,686 @@
+#include "ComponentSystem/ThreadPool.h"
+#include "Game/include/AABBKernel.h"
+#include "Game/include/AABBTree.h"
+#include "Game/include/CollisionManager.h"
+#include "Game/include/ContactCache.h"
+#include "Game/include/SpatialHash.h"
+#include "Game/include/SpatialIndex.h"
+#include "Game/include/SweepAndPrune.h"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+
+namespace
+{
+//Layer 1 wants layer 2, layer 2 wants nothing back.
+std::vector<BroadphaseProxy> MakeProxies(std::size_t count, float worldSize, float maxSize, unsigned seed)
+{
+	std::default_random_engine random(seed);
+	std::uniform_real_distribution<float> position(-worldSize, worldSize);
+	std::uniform_real_distribution<float> size(1.f, maxSize);
+
+	std::vector<BroadphaseProxy> proxies;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const float x(position(random));
+		const float y(position(random));
+		const bool hunter(i % 3 == 0);
+		proxies.emplace_back(BroadphaseProxy { AABB { x, y, x + size(random), y + size(random) }, hunter ? 1u : 2u, hunter ? 2u : 0u });
+	}
+	return proxies;
+}
+
+std::vector<BroadphasePair> BruteForcePairs(const std::vector<BroadphaseProxy>& proxies)
+{
+	std::vector<BroadphasePair> pairs;
+	for (std::uint32_t i = 0; i < proxies.size(); ++i)
+	{
+		for (std::uint32_t j = i + 1; j < proxies.size(); ++j)
+		{
+			if (WantsPair(proxies[i], proxies[j]) && Overlaps(proxies[i].Bounds, proxies[j].Bounds))
+				pairs.emplace_back(BroadphasePair { i, j });
+		}
+	}
+	return pairs;
+}
+
+std::vector<std::uint32_t> BruteForceQuery(const std::vector<BroadphaseProxy>& proxies, const AABB& box, std::uint32_t mask)
+{
+	std::vector<std::uint32_t> result;
+	for (std::uint32_t i = 0; i < proxies.size(); ++i)
+	{
+		if ((proxies[i].Layer & mask) != 0 && Overlaps(proxies[i].Bounds, box))
+			result.emplace_back(i);
+	}
+	return result;
+}
+
+std::vector<std::unique_ptr<Broadphase>> MakeBroadphases()
+{
+	std::vector<std::unique_ptr<Broadphase>> broadphases;
+	broadphases.emplace_back(std::make_unique<SpatialHash>(16.f));
+	broadphases.emplace_back(std::make_unique<SpatialHash>(64.f));
+	broadphases.emplace_back(std::make_unique<SpatialHash>(512.f));
+	broadphases.emplace_back(std::make_unique<SweepAndPrune>());
+	return broadphases;
+}
+
+using Dispatcher = eventpp::EventDispatcher<int, void(const MyEvent&), MyEventPolicies>;
+
+//Which callback, then the handles it was given.
+enum ResponseCallType : std::uint32_t
+{
+	Enter,
+	Stay,
+	Exit
+};
+using ResponseCall = std::array<std::uint32_t, 3>;
+
+//Every response call in order, then the health of every entity.
+struct CrowdRun
+{
+	std::vector<ResponseCall> Calls;
+	std::vector<int> Health;
+	std::size_t MaxPairs { 0 };
+};
+
+//Enemies packed close enough to give thousands of pairs and
+//continuous projectiles through them, moved the same way every run.
+CrowdRun RunCrowd(ComponentSystem::ThreadPool* pool, BroadphaseType type)
+{
+	using namespace ComponentSystem;
+	EntityManager manager;
+	manager.SetThreadPool(pool);
+	Dispatcher dispatcher;
+	CollisionManager collisions(manager, dispatcher);
+	collisions.SetBroadphase(type);
+
+	CrowdRun run;
+	const auto touch = [&run](ResponseCallType call) {
+		return [&run, call](GameEntity& a, GameEntity& b) {
+			run.Calls.emplace_back(ResponseCall { call, a.GetHandle().Value, b.GetHandle().Value });
+			if (call == Enter)
+				b.GetComponent<CStat>().Hit(1);
+		};
+	};
+	const auto exit = [&run](GameEntity* a, GameEntity* b) {
+		run.Calls.emplace_back(ResponseCall { Exit, (a != nullptr ? a->GetHandle() : EntityHandle()).Value, (b != nullptr ? b->GetHandle() : EntityHandle()).Value });
+	};
+	collisions.SetResponse(EntityGroup::Enemy, EntityGroup::Enemy, CollisionResponse { touch(Enter), touch(Stay), exit });
+	collisions.SetResponse(EntityGroup::Projectile, EntityGroup::Enemy, CollisionResponse { touch(Enter), touch(Stay), exit });
+
+	std::default_random_engine random(11);
+	std::uniform_real_distribution<float> position(100.f, 300.f);
+	std::uniform_real_distribution<float> move(-6.f, 6.f);
+	std::vector<EntityHandle> handles;
+	for (int i = 0; i < 400; ++i)
+	{
+		const bool projectile(i % 4 == 0);
+		auto& e(manager.AddEntity(GetComponentBitset<CTransform, CPhysics, CStat>()));
+		e.AddComponent<CTransform>(sf::Vector2f(position(random), position(random)));
+		e.AddComponent<CPhysics>(projectile ? sf::Vector2f(4.f, 4.f) : sf::Vector2f(16.f, 16.f), ScreenWidth, ScreenHeight).Continuous = projectile;
+		e.AddComponent<CStat>(1000, 1.f, dispatcher);
+		e.AddGroup(projectile ? EntityGroup::Projectile : EntityGroup::Enemy);
+		handles.emplace_back(e.GetHandle());
+	}
+	manager.Refresh();
+
+	for (int step = 0; step < 4; ++step)
+	{
+		collisions.TestAllCollision();
+		run.MaxPairs = std::max(run.MaxPairs, collisions.GetBroadphaseStats().Pairs);
+		for (auto& handle : handles)
+		{
+			sf::Vector2f& p(manager.GetEntity(handle).GetComponent<CTransform>().Position);
+			p.x += move(random);
+			p.y += move(random);
+		}
+	}
+
+	for (auto& handle : handles)
+		run.Health.emplace_back(manager.GetEntity(handle).GetComponent<CStat>().Health);
+	return run;
+}
+
+//A 16 by 16 box in no group yet.
+ComponentSystem::GameEntity& AddBox(ComponentSystem::EntityManager& manager, const sf::Vector2f& position)
+{
+	using namespace ComponentSystem;
+	auto& e(manager.AddEntity(GetComponentBitset<CTransform, CPhysics>()));
+	e.AddComponent<CTransform>(position);
+	e.AddComponent<CPhysics>(sf::Vector2f(8.f, 8.f), ScreenWidth, ScreenHeight);
+	return e;
+}
+
+//Records what OnEnter and OnExit were given.
+CollisionResponse RecordResponse(std::vector<ResponseCall>& calls)
+{
+	using ComponentSystem::GameEntity;
+	return CollisionResponse {
+		[&calls](GameEntity& a, GameEntity& b) {
+			calls.emplace_back(ResponseCall { Enter, a.GetHandle().Value, b.GetHandle().Value });
+		},
+		nullptr,
+		[&calls](GameEntity* a, GameEntity* b) {
+			calls.emplace_back(ResponseCall { Exit, a->GetHandle().Value, b->GetHandle().Value });
+		}
+	};
+}
+}
+
+TEST_CASE("Broadphases find the same pairs as testing every pair", "[broadphase]")
+{
+	auto proxies(MakeProxies(400, 1000.f, 120.f, 7));
+	const auto queries(MakeProxies(100, 1100.f, 300.f, 11));
+	std::default_random_engine random(3);
+	std::uniform_real_distribution<float> step(-4.f, 4.f);
+
+	for (auto& broadphase : MakeBroadphases())
+	{
+		auto moving(proxies);
+		for (int frame = 0; frame < 4; ++frame)
+		{
+			broadphase->Update(moving);
+			REQUIRE(broadphase->GetStats().Proxies == moving.size());
+			REQUIRE(broadphase->GetPairs() == BruteForcePairs(moving));
+
+			std::vector<std::uint32_t> found;
+			for (auto& q : queries)
+			{
+				found.clear();
+				broadphase->Query(q.Bounds, 2u, found);
+				std::sort(found.begin(), found.end());
+				REQUIRE(found == BruteForceQuery(moving, q.Bounds, 2u));
+			}
+
+			//Move a bit, drop some and add some like a real step.
+			for (auto& p : moving)
+			{
+				const float dx(step(random));
+				p.Bounds.Left += dx;
+				p.Bounds.Right += dx;
+			}
+			moving.resize(moving.size() - 50);
+			const auto added(MakeProxies(30 + frame * 40, 1000.f, 120.f, 100 + frame));
+			moving.insert(moving.end(), added.begin(), added.end());
+		}
+	}
+}
+
+TEST_CASE("Spatial hash looks at a proxy in many cells once", "[broadphase]")
+{
+	SpatialHash grid(10.f);
+	const std::vector<BroadphaseProxy> proxies {
+		BroadphaseProxy { AABB { -50.f, -50.f, 50.f, 50.f }, 1u, 2u },
+		BroadphaseProxy { AABB { 50.f, 50.f, 51.f, 51.f }, 2u, 0u },
+		BroadphaseProxy { AABB { 200.f, 200.f, 201.f, 201.f }, 2u, 0u }
+	};
+	grid.Update(proxies);
+	REQUIRE(grid.GetStats().Cells == 121 + 1 + 1);
+
+	//Touching edges collide, like CPhysics.
+	REQUIRE(grid.GetPairs() == std::vector<BroadphasePair> { BroadphasePair { 0, 1 } });
+
+	std::vector<std::uint32_t> found;
+	grid.Query(AABB { -40.f, -40.f, 40.f, 40.f }, 1u, found);
+	REQUIRE(found == std::vector<std::uint32_t> { 0 });
+
+	grid.Update({});
+	found.clear();
+	grid.Query(AABB { 0.f, 0.f, 1.f, 1.f }, ~0u, found);
+	REQUIRE(found.empty());
+	REQUIRE(grid.GetPairs().empty());
+}
+
+TEST_CASE("Spatial hash keeps huge boxes out of the grid", "[broadphase]")
+{
+	//Up to 60 by 60 cells, many are too big for the grid.
+	SpatialHash grid(2.f);
+	auto proxies(MakeProxies(300, 200.f, 120.f, 9));
+	proxies.emplace_back(BroadphaseProxy { AABB { -1e30f, -1e30f, 1e30f, 1e30f }, 2u, 0u });
+	proxies.emplace_back(BroadphaseProxy { AABB { 1e30f, 1e30f, 2e30f, 2e30f }, 1u, 2u });
+	grid.Update(proxies);
+	REQUIRE(grid.GetStats().Cells > 0);
+	REQUIRE(grid.GetPairs() == BruteForcePairs(proxies));
+
+	std::vector<std::uint32_t> found;
+	for (auto& q : MakeProxies(50, 250.f, 40.f, 10))
+	{
+		found.clear();
+		grid.Query(q.Bounds, 2u, found);
+		std::sort(found.begin(), found.end());
+		REQUIRE(found == BruteForceQuery(proxies, q.Bounds, 2u));
+	}
+}
+
+TEST_CASE("Sweep and prune only repairs what moved", "[broadphase]")
+{
+	const auto proxies(MakeProxies(300, 1000.f, 50.f, 5));
+	SweepAndPrune sap;
+	sap.Update(proxies);
+	REQUIRE(sap.GetStats().Cells > 0);
+
+	//Nothing moved, the endpoints are still sorted.
+	sap.Update(proxies);
+	REQUIRE(sap.GetStats().Cells == 0);
+	REQUIRE(sap.GetPairs() == BruteForcePairs(proxies));
+
+	//Jumps across the world start and end overlaps, and
+	//the pairs of proxies gone are forgotten.
+	auto moved(proxies);
+	for (std::size_t i = 0; i < moved.size(); i += 7)
+		std::swap(moved[i].Bounds, moved[moved.size() - 1 - i].Bounds);
+	moved.resize(moved.size() - 40);
+	sap.Update(moved);
+	REQUIRE(sap.GetPairs() == BruteForcePairs(moved));
+	sap.Update(proxies);
+	REQUIRE(sap.GetPairs() == BruteForcePairs(proxies));
+
+	//A crowd this dense keeps long active lists, so the
+	//batched test is the one finding the pairs.
+	const auto crowd(MakeProxies(600, 50.f, 40.f, 9));
+	sap.Update(crowd);
+	REQUIRE(sap.GetStats().Candidates > crowd.size() * 64);
+	REQUIRE(sap.GetPairs() == BruteForcePairs(crowd));
+}
+
+TEST_CASE("Every AABB kernel matches the scalar one", "[broadphase]")
+{
+	//Whole numbers so plenty of boxes touch on an edge.
+	std::default_random_engine random(13);
+	std::uniform_int_distribution<int> position(-20, 20);
+	std::uniform_int_distribution<int> size(0, 8);
+	const auto makeBox = [&random, &position, &size]() {
+		const auto x(static_cast<float>(position(random)));
+		const auto y(static_cast<float>(position(random)));
+		return AABB { x, y, x + static_cast<float>(size(random)), y + static_cast<float>(size(random)) };
+	};
+
+	const AABBKernel scalar(GetAABBKernel(AABBKernelType::Scalar));
+	REQUIRE(scalar != nullptr);
+	REQUIRE(GetAABBKernel(GetBestAABBKernelType()) != nullptr);
+
+	//Every tail length, and more than one hit word.
+	for (std::size_t count : { 0u, 1u, 3u, 4u, 5u, 7u, 8u, 9u, 63u, 64u, 65u, 130u, 1000u })
+	{
+		AABBBatch batch;
+		for (std::size_t i = 0; i < count; ++i)
+			batch.Add(makeBox());
+
+		for (int q = 0; q < 20; ++q)
+		{
+			const AABB box(makeBox());
+			std::vector<std::uint64_t> expected(util::GetHitWords(count));
+			scalar(box, batch, expected.data());
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const AABB other { batch.Left[i], batch.Top[i], batch.Right[i], batch.Bottom[i] };
+				REQUIRE(((expected[i / 64] >> (i % 64)) & 1u) == (Overlaps(box, other) ? 1u : 0u));
+			}
+
+			for (auto type : { AABBKernelType::SSE, AABBKernelType::AVX2 })
+			{
+				const AABBKernel kernel(GetAABBKernel(type));
+				if (kernel == nullptr)
+					continue;
+
+				//Stale bits must be overwritten.
+				std::vector<std::uint64_t> hits(util::GetHitWords(count), ~std::uint64_t { 0 });
+				kernel(box, batch, hits.data());
+				INFO(GetAABBKernelName(type) << " with " << count << " boxes");
+				REQUIRE(hits == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("Swept boxes hit what they pass through", "[broadphase]")
+{
+	const AABB bullet { 0.f, 0.f, 2.f, 2.f };
+	const AABB wall { 10.f, -5.f, 11.f, 5.f };
+	float time { -1.f };
+
+	//Jumps clean over the wall in one step, like a bullet at 30 Hz.
+	REQUIRE(SweepAABB(bullet, 20.f, 0.f, wall, time));
+	REQUIRE(time == Approx(0.4f));
+	REQUIRE(SweepAABB(AABB { 30.f, 0.f, 32.f, 2.f }, -20.f, 0.f, wall, time));
+	REQUIRE(time == Approx(0.95f));
+
+	//Stops short, passes beside, or moves away.
+	REQUIRE_FALSE(SweepAABB(bullet, 7.f, 0.f, wall, time));
+	REQUIRE_FALSE(SweepAABB(bullet, 20.f, 40.f, wall, time));
+	REQUIRE_FALSE(SweepAABB(bullet, -20.f, 0.f, wall, time));
+
+	//Touching counts, at the very end of the step too.
+	REQUIRE(SweepAABB(bullet, 8.f, 0.f, wall, time));
+	REQUIRE(time == Approx(1.f));
+
+	//Not moving is the same as the overlap test.
+	REQUIRE(SweepAABB(AABB { 9.f, 0.f, 10.f, 1.f }, 0.f, 0.f, wall, time));
+	REQUIRE(time == 0.f);
+	REQUIRE_FALSE(SweepAABB(bullet, 0.f, 0.f, wall, time));
+
+	//Diagonal through the corner.
+	REQUIRE(SweepAABB(bullet, 20.f, 20.f, AABB { 9.f, 9.f, 10.f, 10.f }, time));
+	REQUIRE(time == Approx(0.35f));
+}
+
+TEST_CASE("AABB tree finds what testing every box finds", "[broadphase]")
+{
+	AABBTree tree;
+	const AABB everything { -1e6f, -1e6f, 1e6f, 1e6f };
+	std::vector<std::uint32_t> found;
+	AABBTree::RayHit hit {};
+	tree.Query(everything, found);
+	REQUIRE(found.empty());
+	REQUIRE_FALSE(tree.Overlaps(everything));
+	REQUIRE_FALSE(tree.Raycast(0.f, 0.f, 1e5f, 0.f, hit));
+
+	std::vector<AABB> boxes;
+	for (auto& p : MakeProxies(500, 1000.f, 60.f, 13))
+		boxes.emplace_back(p.Bounds);
+	tree.Build(boxes);
+	REQUIRE(tree.Size() == boxes.size());
+
+	const auto queries(MakeProxies(200, 1100.f, 200.f, 17));
+	for (std::size_t q = 0; q < queries.size(); ++q)
+	{
+		const AABB& box(queries[q].Bounds);
+		std::vector<std::uint32_t> expected;
+		for (std::uint32_t i = 0; i < boxes.size(); ++i)
+		{
+			if (Overlaps(boxes[i], box))
+				expected.emplace_back(i);
+		}
+		found.clear();
+		tree.Query(box, found);
+		std::sort(found.begin(), found.end());
+		REQUIRE(found == expected);
+		REQUIRE(tree.Overlaps(box) == !expected.empty());
+
+		//From one corner of the query to the opposite one.
+		const AABB origin { box.Left, box.Top, box.Left, box.Top };
+		const float dx(box.Right - box.Left);
+		const float dy(box.Bottom - box.Top);
+		AABBTree::RayHit closest { 0, 2.f };
+		for (std::uint32_t i = 0; i < boxes.size(); ++i)
+		{
+			float time { 0.f };
+			if (SweepAABB(origin, dx, dy, boxes[i], time) && time < closest.Time)
+				closest = AABBTree::RayHit { i, time };
+		}
+		REQUIRE(tree.Raycast(box.Left, box.Top, dx, dy, hit) == (closest.Time <= 1.f));
+		if (closest.Time <= 1.f)
+		{
+			REQUIRE(hit.Id == closest.Id);
+			REQUIRE(hit.Time == closest.Time);
+		}
+	}
+
+	tree.Clear();
+	REQUIRE_FALSE(tree.Overlaps(everything));
+}
+
+TEST_CASE("Spatial queries find what testing every box finds", "[broadphase]")
+{
+	using ComponentSystem::EntityHandle;
+	const auto proxies(MakeProxies(400, 1000.f, 60.f, 19));
+	SweepAndPrune broadphase;
+	broadphase.Update(proxies);
+
+	//Enemies and players from the proxies, plus a few rocks.
+	std::vector<AABB> rocks { AABB { 0.f, 0.f, 50.f, 50.f }, AABB { -300.f, 200.f, -250.f, 260.f } };
+	std::vector<EntityHandle> rockHandles { EntityHandle(1000, 0), EntityHandle(1001, 0) };
+	AABBTree tree;
+	tree.Build(rocks);
+
+	SpatialIndex index;
+	index.Clear(&broadphase);
+	for (std::uint32_t i = 0; i < proxies.size(); ++i)
+		index.Add(EntityHandle(i, 0), proxies[i].Bounds);
+	index.SetObstacles(&tree, rockHandles, rocks);
+
+	const std::uint32_t groups((1u << EntityGroup::Enemy) | (1u << EntityGroup::Obstacle));
+	struct Box
+	{
+		EntityHandle Entity;
+		AABB Bounds;
+	};
+	std::vector<Box> all;
+	for (std::uint32_t i = 0; i < proxies.size(); ++i)
+	{
+		if ((proxies[i].Layer & groups) != 0)
+			all.emplace_back(Box { EntityHandle(i, 0), proxies[i].Bounds });
+	}
+	for (std::size_t i = 0; i < rocks.size(); ++i)
+		all.emplace_back(Box { rockHandles[i], rocks[i] });
+
+	const auto distance = [](const sf::Vector2f& p, const AABB& b) {
+		const float dx(std::max({ b.Left - p.x, 0.f, p.x - b.Right }));
+		const float dy(std::max({ b.Top - p.y, 0.f, p.y - b.Bottom }));
+		return dx * dx + dy * dy;
+	};
+	const auto sorted = [](std::vector<EntityHandle> handles) {
+		std::sort(handles.begin(), handles.end(), [](EntityHandle a, EntityHandle b) { return a.Value < b.Value; });
+		return handles;
+	};
+
+	std::vector<EntityHandle> found(all.size());
+	const auto queries(MakeProxies(50, 1100.f, 200.f, 23));
+	for (auto& q : queries)
+	{
+		const AABB& box(q.Bounds);
+		const sf::Vector2f center(box.Left, box.Top);
+		const float radius(box.Right - box.Left);
+
+		std::vector<EntityHandle> inBox, inRadius;
+		for (auto& b : all)
+		{
+			if (Overlaps(b.Bounds, box))
+				inBox.emplace_back(b.Entity);
+			if (distance(center, b.Bounds) <= radius * radius)
+				inRadius.emplace_back(b.Entity);
+		}
+
+		std::size_t count(index.QueryAABB(box, groups, found.data(), found.size()));
+		REQUIRE(sorted(std::vector<EntityHandle>(found.begin(), found.begin() + count)) == inBox);
+		count = index.QueryRadius(center, radius, groups, found.data(), found.size());
+		REQUIRE(sorted(std::vector<EntityHandle>(found.begin(), found.begin() + count)) == inRadius);
+		//A short buffer still tells how many there were.
+		REQUIRE(index.QueryRadius(center, radius, groups, found.data(), 1) == inRadius.size());
+
+		std::vector<Box> nearest;
+		for (auto& b : all)
+		{
+			if (distance(center, b.Bounds) <= 500.f * 500.f)
+				nearest.emplace_back(b);
+		}
+		std::sort(nearest.begin(), nearest.end(), [&](const Box& a, const Box& b) {
+			const float da(distance(center, a.Bounds));
+			const float db(distance(center, b.Bounds));
+			return da < db || (da == db && a.Entity.Value < b.Entity.Value);
+		});
+		count = index.QueryKNearest(center, 500.f, groups, found.data(), 5);
+		REQUIRE(count == std::min<std::size_t>(5, nearest.size()));
+		for (std::size_t i = 0; i < count; ++i)
+			REQUIRE(found[i] == nearest[i].Entity);
+
+		const sf::Vector2f to(box.Right, box.Bottom);
+		const AABB origin { center.x, center.y, center.x, center.y };
+		SpatialIndex::RayHit closest { EntityHandle(), 2.f };
+		for (auto& b : all)
+		{
+			float time { 0.f };
+			if (SweepAABB(origin, to.x - center.x, to.y - center.y, b.Bounds, time)
+				&& (time < closest.Time || (time == closest.Time && b.Entity.Value < closest.Entity.Value)))
+				closest = SpatialIndex::RayHit { b.Entity, time };
+		}
+		SpatialIndex::RayHit hit {};
+		REQUIRE(index.Raycast(center, to, groups, hit) == (closest.Time <= 1.f));
+		if (closest.Time <= 1.f)
+			REQUIRE(hit.Entity == closest.Entity);
+	}
+}
+
+TEST_CASE("Contacts enter, stay and exit once", "[contacts]")
+{
+	using ComponentSystem::EntityHandle;
+	const Contact ab { EntityHandle(1, 0), EntityHandle(2, 0), 0 };
+	const Contact ac { EntityHandle(1, 0), EntityHandle(3, 0), 0 };
+	const Contact bc { EntityHandle(2, 0), EntityHandle(3, 0), 1 };
+
+	ContactCache cache;
+	std::vector<Contact> entered, stayed, exited;
+	const auto step = [&](std::vector<Contact> touching) {
+		entered.clear();
+		stayed.clear();
+		exited.clear();
+		for (auto& c : touching)
+			cache.Add(c);
+		cache.Update([&entered](const Contact& c) { entered.emplace_back(c); },
+			[&stayed](const Contact& c) { stayed.emplace_back(c); },
+			[&exited](const Contact& c) { exited.emplace_back(c); });
+	};
+
+	//Added out of order and twice, reported once and sorted.
+	step({ ac, ab, ac });
+	REQUIRE(entered == std::vector<Contact> { ab, ac });
+	REQUIRE(stayed.empty());
+	REQUIRE(exited.empty());
+	REQUIRE(cache.IsTouching(EntityHandle(3, 0)));
+
+	step({ ab, bc });
+	REQUIRE(entered == std::vector<Contact> { bc });
+	REQUIRE(stayed == std::vector<Contact> { ab });
+	REQUIRE(exited == std::vector<Contact> { ac });
+	REQUIRE(cache.IsTouching(EntityHandle(1, 0)));
+
+	//Same entity, newer generation: not the same contact.
+	step({ Contact { EntityHandle(1, 1), EntityHandle(2, 0), 0 } });
+	REQUIRE(entered.size() == 1);
+	REQUIRE(exited == std::vector<Contact> { ab, bc });
+	REQUIRE_FALSE(cache.IsTouching(EntityHandle(1, 0)));
+
+	step({});
+	REQUIRE(exited.size() == 1);
+	REQUIRE(cache.GetContacts().empty());
+	REQUIRE_FALSE(cache.IsTouching(EntityHandle(2, 0)));
+
+	//Cleared contacts never exit.
+	step({ ab });
+	cache.Clear();
+	step({});
+	REQUIRE(exited.empty());
+}
+
+TEST_CASE("Threaded contact detection resolves like the serial one", "[contacts]")
+{
+	ComponentSystem::ThreadPool pool(4);
+	for (auto type : { BroadphaseType::SpatialHash, BroadphaseType::SweepAndPrune })
+	{
+		const CrowdRun serial(RunCrowd(nullptr, type));
+		const CrowdRun threaded(RunCrowd(&pool, type));
+
+		//Several slices of 'CollisionManager::PairsPerSlice' pairs.
+		REQUIRE(serial.MaxPairs > 4 * 1024);
+		REQUIRE(threaded.MaxPairs == serial.MaxPairs);
+		REQUIRE_FALSE(serial.Calls.empty());
+		REQUIRE(threaded.Calls == serial.Calls);
+		REQUIRE(threaded.Health == serial.Health);
+	}
+}
+
+TEST_CASE("Groups that collide with nothing get no proxies", "[contacts]")
+{
+	ComponentSystem::EntityManager manager;
+	Dispatcher dispatcher;
+	CollisionManager collisions(manager, dispatcher);
+	std::vector<ResponseCall> calls;
+	collisions.SetResponse(EntityGroup::Projectile, EntityGroup::Enemy, RecordResponse(calls));
+
+	AddBox(manager, sf::Vector2f(100.f, 100.f)).AddGroup(EntityGroup::Enemy);
+	AddBox(manager, sf::Vector2f(104.f, 100.f)).AddGroup(EntityGroup::Projectile);
+	manager.Refresh();
+	collisions.TestAllCollision();
+	REQUIRE(collisions.GetBroadphaseStats().Proxies == 2);
+	REQUIRE(collisions.GetBroadphaseStats().Pairs == 1);
+	REQUIRE(calls.size() == 1);
+
+	//The enemy still waits for players, the projectile has nothing left.
+	collisions.ClearResponse(EntityGroup::Enemy, EntityGroup::Projectile);
+	REQUIRE_FALSE(collisions.GetMatrix().Collides(EntityGroup::Projectile, EntityGroup::Enemy));
+	REQUIRE(collisions.GetMatrix().GetMask(EntityGroup::Projectile) == 0);
+	collisions.ClearContacts();
+	collisions.TestAllCollision();
+	REQUIRE(collisions.GetBroadphaseStats().Proxies == 1);
+	REQUIRE(collisions.GetBroadphaseStats().Pairs == 0);
+	REQUIRE(collisions.GetContacts().GetContacts().empty());
+
+	collisions.ClearResponse(EntityGroup::Enemy, EntityGroup::Player);
+	collisions.TestAllCollision();
+	REQUIRE(collisions.GetBroadphaseStats().Proxies == 0);
+	REQUIRE(collisions.GetBroadphaseStats().Pairs == 0);
+	REQUIRE(calls.size() == 1);
+}
+
+TEST_CASE("Responses get their groups in the order they were registered", "[contacts]")
+{
+	ComponentSystem::EntityManager manager;
+	Dispatcher dispatcher;
+	CollisionManager collisions(manager, dispatcher);
+	auto& enemy(AddBox(manager, sf::Vector2f(100.f, 100.f)));
+	auto& projectile(AddBox(manager, sf::Vector2f(104.f, 100.f)));
+	enemy.AddGroup(EntityGroup::Enemy);
+	projectile.AddGroup(EntityGroup::Projectile);
+	manager.Refresh();
+	const std::uint32_t e(enemy.GetHandle().Value);
+	const std::uint32_t p(projectile.GetHandle().Value);
+
+	//Enemies come first, so the broadphase reports (enemy, projectile).
+	std::vector<ResponseCall> calls;
+	collisions.SetResponse(EntityGroup::Projectile, EntityGroup::Enemy, RecordResponse(calls));
+	collisions.TestAllCollision();
+	projectile.GetComponent<ComponentSystem::CTransform>().Position.x = 300.f;
+	collisions.TestAllCollision();
+	REQUIRE(calls == std::vector<ResponseCall> { { Enter, p, e }, { Exit, p, e } });
+
+	calls.clear();
+	collisions.SetResponse(EntityGroup::Enemy, EntityGroup::Projectile, RecordResponse(calls));
+	projectile.GetComponent<ComponentSystem::CTransform>().Position.x = 104.f;
+	collisions.TestAllCollision();
+	projectile.GetComponent<ComponentSystem::CTransform>().Position.x = 300.f;
+	collisions.TestAllCollision();
+	REQUIRE(calls == std::vector<ResponseCall> { { Enter, e, p }, { Exit, e, p } });
+}
+
+TEST_CASE("Contacts within a group are keyed by handle", "[contacts]")
+{
+	//Same world twice, the groups filled in opposite orders so
+	//the proxies, and the pair the broadphase reports, are flipped.
+	for (bool reversed : { false, true })
+	{
+		ComponentSystem::EntityManager manager;
+		Dispatcher dispatcher;
+		CollisionManager collisions(manager, dispatcher);
+		std::vector<ResponseCall> calls;
+		collisions.SetResponse(EntityGroup::Enemy, EntityGroup::Enemy, RecordResponse(calls));
+
+		auto& first(AddBox(manager, sf::Vector2f(100.f, 100.f)));
+		auto& second(AddBox(manager, sf::Vector2f(104.f, 100.f)));
+		(reversed ? second : first).AddGroup(EntityGroup::Enemy);
+		(reversed ? first : second).AddGroup(EntityGroup::Enemy);
+		manager.Refresh();
+		const std::uint32_t a(first.GetHandle().Value);
+		const std::uint32_t b(second.GetHandle().Value);
+		REQUIRE(a < b);
+
+		collisions.TestAllCollision();
+		collisions.TestAllCollision();
+		REQUIRE(calls == std::vector<ResponseCall> { { Enter, a, b } });
+		REQUIRE(collisions.GetContacts().GetContacts().size() == 1);
+		REQUIRE(collisions.GetContacts().GetContacts()[0].A.Value == a);
+		REQUIRE(collisions.GetContacts().GetContacts()[0].B.Value == b);
+	}
+}
@@ -0,0 +1,402 @@
+#include "ComponentSystem/EntityManager.h"
+#include "ComponentSystem/System.h"
+#include "ComponentSystem/View.h"
+#include "Game/include/Components.h"
+#include <catch2/catch.hpp>
+
+using namespace ComponentSystem;
+
+TEST_CASE("Archetype packs same components together", "[entitymanager]")
+{
+	EntityManager manager;
+	const auto signature(GetComponentBitset<CTransform, CCounter>());
+
+	auto& a(manager.AddEntity(signature));
+	auto& b(manager.AddEntity(signature));
+	auto& tA(a.AddComponent<CTransform>(sf::Vector2f(1.f, 2.f)));
+	auto& tB(b.AddComponent<CTransform>(sf::Vector2f(3.f, 4.f)));
+
+	REQUIRE(a.HasComponent<CTransform>());
+	REQUIRE(&a.GetComponent<CTransform>() == &tA);
+	REQUIRE(tA.Entity == &a);
+	REQUIRE(tB.Position.x == 3.f);
+
+	//Neighbours in the same column.
+	REQUIRE(reinterpret_cast<char*>(&tB) - reinterpret_cast<char*>(&tA) == sizeof(CTransform));
+}
+
+TEST_CASE("Archetype and loose components are updated", "[entitymanager]")
+{
+	EntityManager manager;
+
+	auto& packed(manager.AddEntity(GetComponentBitset<CCounter>()));
+	auto& loose(manager.AddEntity());
+	auto& cPacked(packed.AddComponent<CCounter>());
+	auto& cLoose(loose.AddComponent<CCounter>());
+	cPacked.Counter = 0.f;
+	cLoose.Counter = 0.f;
+
+	manager.Update(0.5f);
+	manager.Update(0.5f);
+
+	REQUIRE(cPacked.Counter == Approx(1.f));
+	REQUIRE(cLoose.Counter == Approx(1.f));
+}
+
+TEST_CASE("Dead entities give their rows back", "[entitymanager]")
+{
+	EntityManager manager;
+	const auto signature(GetComponentBitset<CTransform>());
+
+	auto& a(manager.AddEntity(signature));
+	auto& tA(a.AddComponent<CTransform>());
+	a.Destroy();
+	manager.Refresh();
+
+	//The freed row is reused by the next entity.
+	auto& b(manager.AddEntity(signature));
+	auto& tB(b.AddComponent<CTransform>());
+	REQUIRE(&tB == &tA);
+	REQUIRE(tB.Entity == &b);
+}
+
+TEST_CASE("Handles go stale when entities are recycled", "[entitymanager]")
+{
+	EntityManager manager;
+
+	auto& a(manager.AddEntity());
+	const EntityHandle hA(a.GetHandle());
+	REQUIRE(manager.IsValid(hA));
+	REQUIRE(&manager.GetEntity(hA) == &a);
+
+	//Destroyed but not refreshed yet, still there.
+	a.Destroy();
+	REQUIRE(manager.IsValid(hA));
+
+	manager.Refresh();
+	REQUIRE_FALSE(manager.IsValid(hA));
+	REQUIRE(manager.TryGetEntity(hA) == nullptr);
+
+	//Same slot and object, next generation.
+	auto& b(manager.AddEntity());
+	REQUIRE(&b == &a);
+	REQUIRE(b.GetHandle().Index() == hA.Index());
+	REQUIRE(b.GetHandle().Generation() == hA.Generation() + 1);
+	REQUIRE(b.IsAlive());
+	REQUIRE_FALSE(manager.IsValid(hA));
+	REQUIRE_FALSE(NullEntity.Index() < EntityHandle::MaxEntities);
+}
+
+TEST_CASE("Pools reuse freed blocks", "[entitymanager]")
+{
+	EntityManager manager;
+	const ComponentID id(GetComponentTypeID<CCounter>());
+
+	auto& a(manager.AddEntity());
+	auto& cA(a.AddComponent<CCounter>());
+	REQUIRE(manager.GetComponentStats(id).Live == 1);
+	REQUIRE(manager.GetEntityStats().Live == 1);
+	const std::size_t slabBytes(manager.GetComponentStats(id).SlabBytes);
+	REQUIRE(slabBytes > 0);
+
+	a.Destroy();
+	manager.Refresh();
+	REQUIRE(manager.GetComponentStats(id).Live == 0);
+
+	//Same block again, and no new slab.
+	auto& b(manager.AddEntity());
+	auto& cB(b.AddComponent<CCounter>());
+	REQUIRE(&cB == &cA);
+	REQUIRE(manager.GetComponentStats(id).Live == 1);
+	REQUIRE(manager.GetComponentStats(id).Peak == 1);
+	REQUIRE(manager.GetComponentStats(id).SlabBytes == slabBytes);
+}
+
+TEST_CASE("Systems take over component updates", "[entitymanager]")
+{
+	EntityManager manager;
+	auto& packed(manager.AddEntity(GetComponentBitset<CCounter>()));
+	auto& loose(manager.AddEntity());
+	auto& cPacked(packed.AddComponent<CCounter>());
+	auto& cLoose(loose.AddComponent<CCounter>());
+	cPacked.Counter = 0.f;
+	cLoose.Counter = 0.f;
+
+	manager.AddSystem<LegacyUpdateSystem>();
+	auto& counterSystem(manager.AddSystem<TypedSystem<CCounter>>("Counter"));
+	REQUIRE(manager.GetSystems().size() == 2);
+
+	//Only the System runs them, not the legacy step too.
+	manager.Update(0.5f);
+	REQUIRE(cPacked.Counter == Approx(0.5f));
+	REQUIRE(cLoose.Counter == Approx(0.5f));
+
+	//Disabled, the legacy step picks them up again.
+	counterSystem.Enabled = false;
+	manager.Update(0.5f);
+	REQUIRE(cPacked.Counter == Approx(1.f));
+	REQUIRE(cLoose.Counter == Approx(1.f));
+}
+
+TEST_CASE("Groups are updated without a full sweep", "[entitymanager]")
+{
+	EntityManager manager;
+	constexpr Group group { 3 };
+
+	auto& a(manager.AddEntity());
+	auto& b(manager.AddEntity());
+	auto& c(manager.AddEntity());
+	a.AddGroup(group);
+	b.AddGroup(group);
+	c.AddGroup(group);
+	b.AddGroup(group);
+	REQUIRE(manager.GetEntitiesByGroup(group).size() == 3);
+
+	//Leaving a group is immediate.
+	a.DeleteGroup(group);
+	REQUIRE_FALSE(a.HasGroup(group));
+	REQUIRE(manager.GetEntitiesByGroup(group).size() == 2);
+
+	//Dead entities stay until the next Refresh().
+	const EntityHandle hB(b.GetHandle());
+	b.Destroy();
+	b.Destroy();
+	REQUIRE(manager.GetEntitiesByGroup(group).size() == 2);
+
+	manager.Refresh();
+	const auto& grouped(manager.GetEntitiesByGroup(group));
+	REQUIRE(grouped.size() == 1);
+	REQUIRE(grouped[0] == c.GetHandle());
+	REQUIRE_FALSE(manager.IsValid(hB));
+	REQUIRE(manager.GetEntities().size() == 2);
+
+	//Nothing changed, nothing to do.
+	manager.Refresh();
+	REQUIRE(manager.GetEntities().size() == 2);
+	REQUIRE(c.IsAlive());
+}
+
+TEST_CASE("Views visit entities having every component", "[entitymanager]")
+{
+	//Registered components have their ID at compile time.
+	static_assert(GetComponentTypeID<CCounter>() == 0);
+	static_assert(GetComponentTypeID<CTransform>() == 1);
+
+	EntityManager manager;
+	auto& packed(manager.AddEntity(GetComponentBitset<CTransform, CCounter>()));
+	auto& loose(manager.AddEntity());
+	auto& partial(manager.AddEntity(GetComponentBitset<CTransform>()));
+	auto& dead(manager.AddEntity(GetComponentBitset<CTransform, CCounter>()));
+	packed.AddComponent<CTransform>(sf::Vector2f(1.f, 0.f));
+	packed.AddComponent<CCounter>();
+	loose.AddComponent<CTransform>(sf::Vector2f(2.f, 0.f));
+	loose.AddComponent<CCounter>();
+	partial.AddComponent<CTransform>(sf::Vector2f(4.f, 0.f));
+	dead.AddComponent<CTransform>(sf::Vector2f(8.f, 0.f));
+	dead.AddComponent<CCounter>();
+	dead.Destroy();
+	manager.Refresh();
+
+	float sum { 0.f };
+	int count { 0 };
+	manager.View<CTransform, CCounter>().ForEach([&](GameEntity& mEntity, CTransform& mTransform, CCounter& mCounter) {
+		REQUIRE(&mEntity.GetComponent<CTransform>() == &mTransform);
+		REQUIRE(&mEntity.GetComponent<CCounter>() == &mCounter);
+		sum += mTransform.Position.x;
+		++count;
+	});
+
+	REQUIRE(count == 2);
+	REQUIRE(sum == Approx(3.f));
+}
+
+TEST_CASE("Structural changes wait for Refresh", "[entitymanager]")
+{
+	EntityManager manager;
+	constexpr Group group { 1 };
+	auto& commands(manager.GetCommandBuffer());
+
+	auto& a(manager.AddEntity());
+	const EntityHandle hA(a.GetHandle());
+	commands.Create(GetComponentBitset<CTransform>(), [](GameEntity& mEntity) {
+		mEntity.AddComponent<CTransform>(sf::Vector2f(5.f, 0.f));
+		mEntity.AddGroup(group);
+	});
+	commands.AddComponent<CTransform>(hA, sf::Vector2f(1.f, 0.f));
+	commands.AddGroup(hA, group);
+
+	//Nothing happened yet.
+	REQUIRE(manager.GetEntities().size() == 1);
+	REQUIRE_FALSE(a.HasComponent<CTransform>());
+	REQUIRE(manager.GetEntitiesByGroup(group).empty());
+
+	manager.Refresh();
+	REQUIRE(commands.IsEmpty());
+	REQUIRE(manager.GetEntities().size() == 2);
+	REQUIRE(a.GetComponent<CTransform>().Position.x == 1.f);
+	REQUIRE(manager.GetEntitiesByGroup(group).size() == 2);
+
+	//Destroying is deferred too, commands on stale handles are dropped.
+	a.Destroy();
+	REQUIRE(a.IsAlive());
+	commands.AddGroup(hA, group + 1);
+	manager.Refresh();
+	REQUIRE_FALSE(manager.IsValid(hA));
+	REQUIRE(manager.GetEntitiesByGroup(group).size() == 1);
+	REQUIRE(manager.GetEntitiesByGroup(group + 1).empty());
+}
+
+namespace
+{
+struct CountingSystem : System
+{
+	std::atomic<int> Runs { 0 };
+
+	CountingSystem(const ComponentBitset& mReads, const ComponentBitset& mWrites) :
+		System("Counting", ComponentBitset {})
+	{
+		DeclareAccess(mReads, mWrites);
+	}
+
+	void Update(EntityManager&, float) override
+	{
+		++Runs;
+	}
+};
+
+struct ParallelCounterSystem : TypedSystem<CCounter>
+{
+	ParallelCounterSystem() :
+		TypedSystem("ParallelCounter")
+	{
+		DeclareAccess(ComponentBitset {}, GetComponentBitset<CCounter>());
+		SetParallel(true);
+	}
+};
+}
+
+TEST_CASE("Thread pool splits work over every index", "[entitymanager]")
+{
+	ThreadPool pool(3);
+	std::vector<int> hits(10000, 0);
+	pool.ParallelFor(hits.size(), 16, [&hits](std::size_t mBegin, std::size_t mEnd) {
+		for (std::size_t i = mBegin; i < mEnd; ++i)
+			++hits[i];
+	});
+
+	REQUIRE(std::count(hits.begin(), hits.end(), 1) == static_cast<long>(hits.size()));
+}
+
+TEST_CASE("Systems without conflicts share a stage", "[entitymanager]")
+{
+	ThreadPool pool(2);
+	EntityManager manager;
+	manager.SetThreadPool(&pool);
+
+	const auto transform(GetComponentBitset<CTransform>());
+	const auto physics(GetComponentBitset<CPhysics>());
+	auto& a(manager.AddSystem<CountingSystem>(transform, physics));
+	auto& b(manager.AddSystem<CountingSystem>(transform, GetComponentBitset<CStat>()));
+	auto& c(manager.AddSystem<CountingSystem>(physics, transform));
+	auto& legacy(manager.AddSystem<LegacyUpdateSystem>());
+
+	manager.Update(0.f);
+	const auto& stages(manager.GetSystemStages());
+	REQUIRE(stages.size() == 3);
+	REQUIRE(stages[0] == SystemStage { &a, &b });
+	REQUIRE(stages[1] == SystemStage { &c });
+	REQUIRE(stages[2] == SystemStage { &legacy });
+	REQUIRE(a.Runs == 1);
+	REQUIRE(b.Runs == 1);
+	REQUIRE(c.Runs == 1);
+}
+
+TEST_CASE("Parallel Systems update every component once", "[entitymanager]")
+{
+	ThreadPool pool(3);
+	EntityManager manager;
+	manager.SetThreadPool(&pool);
+	manager.AddSystem<ParallelCounterSystem>();
+
+	std::vector<CCounter*> counters;
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto& c(manager.AddEntity(GetComponentBitset<CCounter>()).AddComponent<CCounter>());
+		c.Counter = 0.f;
+		counters.emplace_back(&c);
+	}
+
+	manager.Update(1.f);
+	manager.Update(1.f);
+	const auto updatedTwice(std::count_if(counters.begin(), counters.end(), [](CCounter* mCounter) {
+		return mCounter->Counter == Approx(2.f);
+	}));
+	REQUIRE(updatedTwice == static_cast<long>(counters.size()));
+}
+
+TEST_CASE("Snapshots restore entities, groups and handles", "[entitymanager]")
+{
+	EntityManager manager;
+	auto& packed(manager.AddEntity(GetComponentBitset<CTransform, CCounter>()));
+	packed.AddComponent<CTransform>(sf::Vector2f(3.f, 4.f)).Rotation = 90.f;
+	packed.AddComponent<CCounter>().Counter = 2.5f;
+	packed.AddGroup(1);
+
+	auto& loose(manager.AddEntity());
+	loose.AddComponent<CCounter>().Counter = 7.f;
+	loose.AddGroup(2);
+
+	auto& dead(manager.AddEntity());
+	dead.AddComponent<CCounter>().Counter = 1.f;
+	manager.DestroyEntity(dead);
+
+	const EntityHandle savedLoose(loose.GetHandle());
+	SnapshotWriter writer;
+	manager.SaveSnapshot(writer);
+
+	//Mess the world up, the snapshot must bring it back.
+	packed.GetComponent<CTransform>().Position = sf::Vector2f();
+	manager.AddEntity().AddComponent<CCounter>();
+	manager.Refresh();
+
+	SnapshotReader reader(writer.GetBuffer());
+	const bool loaded(manager.LoadSnapshot(reader, [](GameEntity& mEntity, ComponentID mID, SnapshotReader&) -> Component* {
+		if (mID == GetComponentTypeID<CTransform>())
+			return &mEntity.AddComponent<CTransform>();
+		if (mID == GetComponentTypeID<CCounter>())
+			return &mEntity.AddComponent<CCounter>();
+		return nullptr;
+	}));
+	REQUIRE(loaded);
+	REQUIRE(manager.GetEntities().size() == 2);
+
+	REQUIRE(manager.GetEntitiesByGroup(1).size() == 1);
+	auto& restoredPacked(manager.GetEntity(manager.GetEntitiesByGroup(1)[0]));
+	REQUIRE(restoredPacked.GetArchetype() != nullptr);
+	REQUIRE(restoredPacked.GetComponent<CTransform>().Position == sf::Vector2f(3.f, 4.f));
+	REQUIRE(restoredPacked.GetComponent<CTransform>().Rotation == Approx(90.f));
+	REQUIRE(restoredPacked.GetComponent<CCounter>().Counter == Approx(2.5f));
+
+	REQUIRE(manager.GetEntitiesByGroup(2).size() == 1);
+	const EntityHandle restoredLoose(manager.GetEntitiesByGroup(2)[0]);
+	REQUIRE(restoredLoose != savedLoose);
+	REQUIRE(manager.GetEntity(restoredLoose).GetComponent<CCounter>().Counter == Approx(7.f));
+
+	//Saved handles map to the restored entities.
+	SnapshotWriter handleWriter;
+	handleWriter.WriteHandle(savedLoose);
+	SnapshotReader handleReader(handleWriter.GetBuffer());
+	handleReader.MapHandle(savedLoose, restoredLoose);
+	REQUIRE(handleReader.ReadHandle() == restoredLoose);
+	REQUIRE(handleReader.ReadHandle() == NullEntity);
+	REQUIRE_FALSE(handleReader.IsValid());
+
+	SnapshotReader broken(writer.GetBuffer().data(), 4);
+	REQUIRE_FALSE(manager.LoadSnapshot(broken, nullptr));
+
+	//Cut in the component blocks, the world is left as it was.
+	SnapshotReader truncated(writer.GetBuffer().data(), writer.GetBuffer().size() - 1);
+	REQUIRE_FALSE(manager.LoadSnapshot(truncated, nullptr));
+	REQUIRE(manager.GetEntities().size() == 2);
+	REQUIRE(manager.GetEntity(restoredLoose).GetComponent<CCounter>().Counter == Approx(7.f));
+}
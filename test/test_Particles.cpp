@@ -0,0 +1,105 @@
+#include "Game/include/ParticlePool.h"
+#include "Utility/BitMask.hpp"
+#include <catch2/catch.hpp>
+#include <random>
+
+TEST_CASE("Particle bursts share one pool", "[particles]")
+{
+	ParticlePool pool(100);
+	const auto a(pool.CreateEmitter());
+	const auto b(pool.CreateEmitter());
+	REQUIRE(a != b);
+
+	pool.GetEmitter(a).Position = sf::Vector2f(ScreenWidth / 2, ScreenHeight / 2);
+	pool.GetEmitter(a).Speed = 100.f;
+	pool.GetEmitter(a).ShapeType = Shape::CIRCLE;
+	pool.GetEmitter(b).Position = sf::Vector2f(10.f, 10.f);
+	pool.GetEmitter(b).Speed = 100.f;
+	pool.GetEmitter(b).Gravity = sf::Vector2f(0.f, -5.f);
+
+	REQUIRE(pool.Burst(a, 60) == 60);
+	//Only what is left of the pool.
+	REQUIRE(pool.Burst(b, 60) == 40);
+	REQUIRE(pool.Size() == 100);
+
+	//Bursts outlive their emitter, its ID is given again.
+	pool.DestroyEmitter(a);
+	REQUIRE(pool.CreateEmitter() == a);
+	REQUIRE(pool.Size() == 100);
+
+	//Circles fade out, squares fly off screen, both end.
+	std::size_t last(pool.Size());
+	for (int i = 0; i < 10000 && pool.Size() > 0; ++i)
+	{
+		pool.Update(1.f / 60.f);
+		REQUIRE(pool.Size() <= last);
+		last = pool.Size();
+	}
+	REQUIRE(pool.Size() == 0);
+
+	pool.Burst(b, 10);
+	pool.Clear();
+	REQUIRE(pool.Size() == 0);
+}
+
+TEST_CASE("Every particle kernel matches the scalar one", "[particles]")
+{
+	//Some leave the screen, some fade out, some stay.
+	std::default_random_engine random(21);
+	std::uniform_real_distribution<float> position(-10.f, ScreenWidth + 10.f);
+	std::uniform_real_distribution<float> velocity(-1.f, 1.f);
+	std::uniform_real_distribution<float> fade(0.f, 40.f);
+	const auto makeBatch = [&random, &position, &velocity, &fade](std::size_t count) {
+		ParticleBatch batch;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const sf::Vector2f p(position(random), position(random) * ScreenHeight / ScreenWidth);
+			batch.Add(Particle { p, sf::Vector2f(velocity(random), velocity(random)), sf::Vector2f(velocity(random), velocity(random)),
+				100.f, i % 3 == 0 ? 0.f : fade(random), sf::Color::White });
+		}
+		return batch;
+	};
+
+	const ParticleKernel scalar(GetParticleKernel(ParticleKernelType::Scalar));
+	REQUIRE(scalar != nullptr);
+	REQUIRE(GetParticleKernel(GetBestParticleKernelType()) != nullptr);
+
+	//Every tail length, and more than one alive word.
+	for (std::size_t count : { 0u, 1u, 3u, 4u, 5u, 7u, 8u, 9u, 63u, 64u, 65u, 130u, 1000u })
+	{
+		const ParticleBatch start(makeBatch(count));
+		ParticleBatch expected(start);
+		std::vector<std::uint64_t> expectedAlive(util::GetHitWords(count));
+		scalar(expected, 1.f / 60.f, expectedAlive.data());
+
+		for (auto type : { ParticleKernelType::SSE, ParticleKernelType::AVX2 })
+		{
+			const ParticleKernel kernel(GetParticleKernel(type));
+			if (kernel == nullptr)
+				continue;
+
+			//Stale bits must be overwritten.
+			ParticleBatch batch(start);
+			std::vector<std::uint64_t> alive(util::GetHitWords(count), ~std::uint64_t { 0 });
+			kernel(batch, 1.f / 60.f, alive.data());
+			INFO(GetParticleKernelName(type) << " with " << count << " particles");
+			REQUIRE(alive == expectedAlive);
+			REQUIRE(batch.X == expected.X);
+			REQUIRE(batch.Y == expected.Y);
+			REQUIRE(batch.VelocityX == expected.VelocityX);
+			REQUIRE(batch.VelocityY == expected.VelocityY);
+			REQUIRE(batch.Alpha == expected.Alpha);
+		}
+
+		//Survivors keep their order.
+		std::vector<float> survivors;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if ((expectedAlive[i / 64] >> (i % 64)) & 1u)
+				survivors.emplace_back(expected.X[i]);
+		}
+		REQUIRE(CompactParticles(expected, expectedAlive) == survivors.size());
+		REQUIRE(expected.X == survivors);
+		REQUIRE(expected.Color.size() == survivors.size());
+	}
+}
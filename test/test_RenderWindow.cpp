@@ -1,3 +1,5 @@
+#include "Game/include/SpriteBatch.h"
+#include "Game/include/TextureCache.h"
 #include <catch2/catch.hpp>
 
 // This example is a bit silly, but you get the idea
@@ -30,4 +32,87 @@ TEST_CASE("sf::RenderWindow", "[renderwindow]")
 	window.display();
 
 	REQUIRE(window.isOpen() == true);
-}
\ No newline at end of file
+}
+
+TEST_CASE("SpriteBatch draws once per texture", "[renderwindow]")
+{
+	sf::RenderWindow window(sf::VideoMode(200, 200), "SFM works!", sf::Style::Titlebar | sf::Style::Close);
+	sf::Texture even, odd;
+	REQUIRE(even.loadFromFile("content/sfml.png"));
+	REQUIRE(odd.loadFromFile("content/sfml.png"));
+
+	SpriteBatch batch;
+	std::vector<sf::Sprite> sprites(10);
+	for (std::size_t i = 0; i < sprites.size(); ++i)
+	{
+		sprites[i].setTexture(i % 2 == 0 ? even : odd);
+		sprites[i].setPosition(static_cast<float>(i * 10), 0.f);
+		sprites[i].setRotation(static_cast<float>(i * 30));
+		if (i % 2 == 1)
+			sprites[i].setScale(1.5f, 0.5f);
+		batch.Add(sprites[i]);
+	}
+	sprites[0].setColor(sf::Color::Red);
+	sprites[1].setTextureRect(sf::IntRect(16, 32, 64, 48));
+	batch.Clear();
+	for (std::size_t i = 0; i < sprites.size(); ++i)
+		batch.Add(sprites[i]);
+
+	window.clear();
+	batch.Draw(window);
+	window.display();
+
+	//Cleared, not added twice.
+	REQUIRE(batch.GetSpriteCount() == 10);
+	REQUIRE(batch.GetDrawCalls() == 2);
+
+	//Each quad is the sprite as SFML would draw it.
+	const sf::VertexArray* quads[] { batch.GetQuads(&even), batch.GetQuads(&odd) };
+	REQUIRE(quads[0] != nullptr);
+	REQUIRE(quads[1] != nullptr);
+	REQUIRE(quads[0]->getVertexCount() == 20);
+	REQUIRE(quads[1]->getVertexCount() == 20);
+	for (std::size_t i = 0; i < sprites.size(); ++i)
+	{
+		const sf::Transform& transform(sprites[i].getTransform());
+		const sf::FloatRect local(sprites[i].getLocalBounds());
+		const sf::IntRect& rect(sprites[i].getTextureRect());
+		const sf::Vector2f corners[] { { 0.f, 0.f }, { local.width, 0.f }, { local.width, local.height }, { 0.f, local.height } };
+		const sf::Vector2f texCoords[] {
+			{ static_cast<float>(rect.left), static_cast<float>(rect.top) },
+			{ static_cast<float>(rect.left + rect.width), static_cast<float>(rect.top) },
+			{ static_cast<float>(rect.left + rect.width), static_cast<float>(rect.top + rect.height) },
+			{ static_cast<float>(rect.left), static_cast<float>(rect.top + rect.height) }
+		};
+
+		for (std::size_t k = 0; k < 4; ++k)
+		{
+			const sf::Vertex& vertex((*quads[i % 2])[(i / 2) * 4 + k]);
+			const sf::Vector2f expected(transform.transformPoint(corners[k]));
+			REQUIRE(vertex.position.x == Approx(expected.x));
+			REQUIRE(vertex.position.y == Approx(expected.y));
+			REQUIRE(vertex.texCoords == texCoords[k]);
+			REQUIRE(vertex.color == (i == 0 ? sf::Color::Red : sf::Color::White));
+		}
+	}
+}
+
+TEST_CASE("Textures are loaded once and shared", "[renderwindow]")
+{
+	sf::RenderWindow window(sf::VideoMode(200, 200), "SFM works!", sf::Style::Titlebar | sf::Style::Close);
+	TextureCache cache;
+
+	auto first(cache.Get("content/sfml.png"));
+	auto second(cache.Get("content/sfml.png"));
+	REQUIRE(first != nullptr);
+	REQUIRE(first == second);
+	REQUIRE(cache.Get("content/missing.png") == nullptr);
+	REQUIRE(cache.Size() == 2);
+
+	//Still held, then only the cache holds it.
+	REQUIRE(cache.Prune() == 0);
+	first.reset();
+	second.reset();
+	REQUIRE(cache.Prune() == 1);
+	REQUIRE(cache.Size() == 1);
+}
@@ -0,0 +1,73 @@
+#include "Game/include/TextureAtlas.h"
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <random>
+
+TEST_CASE("Atlas regions fit their page without overlapping", "[atlas]")
+{
+	std::default_random_engine random(5);
+	std::uniform_int_distribution<unsigned> size(1, 60);
+	std::vector<sf::Vector2u> sizes;
+	for (int i = 0; i < 300; ++i)
+		sizes.emplace_back(size(random), size(random));
+
+	const unsigned pageSize(256);
+	const unsigned padding(2);
+	std::vector<AtlasRegion> regions;
+	const std::size_t pages(PackAtlas(sizes, pageSize, padding, regions));
+	REQUIRE(pages > 1);
+	REQUIRE(regions.size() == sizes.size());
+
+	for (std::size_t i = 0; i < regions.size(); ++i)
+	{
+		const AtlasRegion& a(regions[i]);
+		REQUIRE(a.Page < pages);
+		REQUIRE(a.Width == sizes[i].x);
+		REQUIRE(a.Height == sizes[i].y);
+		REQUIRE(a.Left >= padding);
+		REQUIRE(a.Top >= padding);
+		REQUIRE(a.Left + a.Width + padding <= pageSize);
+		REQUIRE(a.Top + a.Height + padding <= pageSize);
+
+		for (std::size_t j = i + 1; j < regions.size(); ++j)
+		{
+			const AtlasRegion& b(regions[j]);
+			const bool apart(a.Page != b.Page
+				|| a.Left + a.Width + padding <= b.Left || b.Left + b.Width + padding <= a.Left
+				|| a.Top + a.Height + padding <= b.Top || b.Top + b.Height + padding <= a.Top);
+			REQUIRE(apart);
+		}
+	}
+
+	//Too big for a page.
+	sizes.emplace_back(pageSize, 1);
+	REQUIRE(PackAtlas(sizes, pageSize, padding, regions) == 0);
+}
+
+TEST_CASE("Atlas manifests load what was saved", "[atlas]")
+{
+	AtlasManifest saved;
+	saved.Pages = { "atlas0.png", "atlas1.png" };
+	saved.Names = { "Resources/Texture/Character/player.png", "Resources/Texture/Object/rock.png" };
+	saved.Regions = { AtlasRegion { 0, 2, 2, 20, 20 }, AtlasRegion { 1, 24, 2, 35, 40 } };
+	const std::string path("test_atlas.bin");
+	REQUIRE(saved.Save(path));
+
+	AtlasManifest loaded;
+	REQUIRE(loaded.Load(path));
+	REQUIRE(loaded.Pages == saved.Pages);
+	REQUIRE(loaded.Names == saved.Names);
+	REQUIRE(loaded.Regions.size() == 2);
+	REQUIRE(loaded.Regions[1].Page == 1);
+	REQUIRE(loaded.Regions[1].Left == 24);
+	REQUIRE(loaded.Regions[1].Height == 40);
+
+	//A region on a page that is not there.
+	saved.Pages.pop_back();
+	REQUIRE(saved.Save(path));
+	REQUIRE_FALSE(loaded.Load(path));
+	REQUIRE(loaded.Regions.empty());
+
+	std::remove(path.c_str());
+	REQUIRE_FALSE(loaded.Load(path));
+}
@@ -0,0 +1,79 @@
+#include "Game/include/TextureAtlas.h"
+using namespace std;
+
+/////////////////////////////////////////////////
+///
+///Packs textures into atlas pages, see
+///TextureAtlas.h. Run by 'make atlas':
+///
+///  AtlasPacker <output folder> <texture>...
+///
+///Each texture is known by its path as given,
+///so give the paths the game loads them by.
+///
+/////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		cout << "Usage: " << argv[0] << " <output folder> <texture>..." << endl;
+		return 1;
+	}
+
+	const string folder(argv[1]);
+	vector<sf::Image> images(static_cast<size_t>(argc - 2));
+	vector<sf::Vector2u> sizes;
+	AtlasManifest manifest;
+	for (int i = 2; i < argc; ++i)
+	{
+		sf::Image& image(images[static_cast<size_t>(i - 2)]);
+		if (!image.loadFromFile(argv[i]))
+		{
+			cout << "Error! Texture " << argv[i] << " not found!" << endl;
+			return 1;
+		}
+		sizes.emplace_back(image.getSize());
+		manifest.Names.emplace_back(argv[i]);
+	}
+
+	const size_t pageCount(PackAtlas(sizes, AtlasPageSize, AtlasPadding, manifest.Regions));
+	if (pageCount == 0)
+	{
+		cout << "Error! A texture is bigger than an atlas page!" << endl;
+		return 1;
+	}
+
+	//Pages are cut down to what they use.
+	vector<sf::Vector2u> used(pageCount, sf::Vector2u(0, 0));
+	for (auto& r : manifest.Regions)
+	{
+		used[r.Page].x = max(used[r.Page].x, static_cast<unsigned>(r.Left + r.Width + AtlasPadding));
+		used[r.Page].y = max(used[r.Page].y, static_cast<unsigned>(r.Top + r.Height + AtlasPadding));
+	}
+
+	for (size_t page = 0; page < pageCount; ++page)
+	{
+		sf::Image atlas;
+		atlas.create(used[page].x, used[page].y, sf::Color::Transparent);
+		for (size_t i = 0; i < images.size(); ++i)
+		{
+			const AtlasRegion& r(manifest.Regions[i]);
+			if (r.Page == page)
+				atlas.copy(images[i], r.Left, r.Top);
+		}
+
+		const string name("atlas" + to_string(page) + ".png");
+		if (!atlas.saveToFile(folder + "/" + name))
+		{
+			cout << "Error! Can not write atlas page " << name << endl;
+			return 1;
+		}
+		manifest.Pages.emplace_back(name);
+	}
+
+	if (!manifest.Save(folder + "/atlas.bin"))
+		return 1;
+
+	cout << "Packed " << images.size() << " textures into " << pageCount << " atlas pages." << endl;
+	return 0;
+}